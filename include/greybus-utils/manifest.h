@@ -61,11 +61,13 @@
  * - Loopback
  * - Log
  * - Raw
+ * - Telemetry
  */
 #define _GREYBUS_SPECIAL_CPORTS                                                                    \
 	(1 + COND_CODE_1(CONFIG_GREYBUS_LOOPBACK, (1), (0)) +                                      \
 	 COND_CODE_1(CONFIG_GREYBUS_FW, (2), (0)) +                                                \
-	 COND_CODE_1(CONFIG_GREYBUS_LOG_BACKEND, (1), (0)) + GREYBUS_RAW_CPORT_COUNT)
+	 COND_CODE_1(CONFIG_GREYBUS_LOG_BACKEND, (1), (0)) + GREYBUS_RAW_CPORT_COUNT +             \
+	 COND_CODE_1(CONFIG_GREYBUS_TELEMETRY, (1), (0)))
 
 #define GREYBUS_CPORT_COUNT                                                                        \
 	(_GREYBUS_SPECIAL_CPORTS +                                                                 \
@@ -73,6 +75,18 @@
 		     (DT_FOREACH_CHILD_STATUS_OKAY_SEP(_GREYBUS_BASE_NODE, _GREYBUS_CPORT_COUNTER, \
 						       (+)))))
 
+#define _GREYBUS_BRIDGED_PHY_PROP_LEN(_node_id, prop)                                              \
+	+COND_CODE_1(DT_NODE_HAS_COMPAT_STATUS(_node_id, zephyr_greybus_bundle_bridged_phy, okay), \
+		     (DT_PROP_LEN_OR(_node_id, prop, 0)), (0))
+
+/*
+ * Number of controllers listed in a property of the bridged phy bundles, e.g. the number of i2c
+ * cports for i2c_controllers.
+ */
+#define GREYBUS_BRIDGED_PHY_PROP_COUNT(prop)                                                       \
+	(0 DT_FOREACH_CHILD_STATUS_OKAY_VARGS(_GREYBUS_BASE_NODE, _GREYBUS_BRIDGED_PHY_PROP_LEN,   \
+					      prop))
+
 #define GREYBUS_FW_MANAGEMENT_CPORT 1
 #define GREYBUS_FW_DOWNLOAD_CPORT   2
 #define GREYBUS_LOG_CPORT           COND_CODE_1(CONFIG_GREYBUS_FW, (3), (1))
@@ -80,6 +94,9 @@
 	(COND_CODE_1(CONFIG_GREYBUS_FW, (2), (0)) +                                                \
 	 COND_CODE_1(CONFIG_GREYBUS_LOG_BACKEND, (1), (0)) + 1)
 #define GREYBUS_RAW_CPORT_COUNT COND_CODE_1(CONFIG_GREYBUS_RAW, (CONFIG_GREYBUS_RAW_CPORTS), (0))
+#define GREYBUS_TELEMETRY_CPORT                                                                    \
+	(GREYBUS_RAW_CPORT_START + GREYBUS_RAW_CPORT_COUNT +                                       \
+	 COND_CODE_1(CONFIG_GREYBUS_LOOPBACK, (1), (0)))
 
 typedef void (*manifest_handler)(unsigned char *manifest_file, int device_id, int manifest_number);
 
@@ -96,6 +113,19 @@ int manifest_create(uint8_t buf[], size_t len);
  */
 size_t manifest_size(void);
 
+/**
+ * Build the greybus manifest returned by manifest_get.
+ *
+ * @return 0 if successful.
+ * @return -errno in case of error.
+ */
+int manifest_init(void);
+
+/**
+ * Get the greybus manifest built by manifest_init. The manifest is manifest_size bytes long.
+ */
+const uint8_t *manifest_get(void);
+
 /**
  * Print greybus manifest to stdout. Intended for debugging.
  */
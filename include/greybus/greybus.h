@@ -41,6 +41,15 @@ struct gb_msg_with_cport {
 	struct gb_message *msg;
 };
 
+/**
+ * A fragment of a greybus message. The fragments of a message are sent back to back, starting
+ * with the greybus header.
+ */
+struct gb_iovec {
+	const void *base;
+	size_t len;
+};
+
 /**
  * Greybus transport backend structure.
  */
@@ -55,6 +64,12 @@ struct gb_transport_backend {
 	int (*stop_listening)(uint16_t cport);
 	/* Send greybus message */
 	int (*send)(uint16_t cport, const struct gb_message *msg);
+	/* Send greybus message gathered from fragments. Optional. */
+	int (*send_iov)(uint16_t cport, const struct gb_iovec *iov, size_t iovcnt);
+	/* Send greybus message, taking over the reference of the caller even on failure. The
+	 * message can be held until it is transmitted, and is released with gb_message_put.
+	 * Optional. */
+	int (*send_ref)(uint16_t cport, struct gb_message *msg);
 };
 
 /**
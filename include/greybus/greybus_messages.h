@@ -7,6 +7,7 @@
 #define _GREYBUS_MESSAGES_H_
 
 #include <zephyr/types.h>
+#include <zephyr/sys/__assert.h>
 #include <zephyr/sys/byteorder.h>
 #include <greybus/greybus_protocols.h>
 
@@ -130,10 +131,35 @@ struct gb_message *gb_message_alloc(size_t payload_len, uint8_t message_type, ui
 /*
  * Deallocate a greybus message.
  *
- * @param pointer to the message to deallcate
+ * With CONFIG_GREYBUS_MESSAGE_REFCOUNT, this drops a reference, and the message is only freed
+ * once the last reference is dropped.
+ *
+ * @param pointer to the message to deallcate. Can be NULL.
  */
 void gb_message_dealloc(struct gb_message *msg);
 
+/*
+ * Take a reference to a greybus message, which must be dropped with gb_message_put.
+ *
+ * Without CONFIG_GREYBUS_MESSAGE_REFCOUNT, this returns a copy of the message instead, so callers
+ * do not need to care which is the case as long as they do not modify the message.
+ *
+ * @param msg: message allocated with gb_message_alloc
+ *
+ * @return message. NULL if a copy could not be allocated.
+ */
+struct gb_message *gb_message_get(struct gb_message *msg);
+
+/*
+ * Drop a reference to a greybus message.
+ *
+ * @param msg: message. Can be NULL.
+ */
+static inline void gb_message_put(struct gb_message *msg)
+{
+	gb_message_dealloc(msg);
+}
+
 /*
  * Allocate a greybus request message
  *
@@ -170,6 +196,39 @@ static inline struct gb_message *gb_message_request_alloc_with_payload(const voi
 	return req;
 }
 
+/**
+ * Reserve a response to a request, so that the handler can write it in place.
+ *
+ * The payload is sized for the largest response the handler can produce. Once it has been
+ * written, gb_message_response_commit sets the actual length.
+ *
+ * @param req: request to respond to
+ * @param max_payload_len: maximum payload length of the response
+ *
+ * @return successful response allocated on heap. Null in case of error
+ */
+static inline struct gb_message *gb_message_response_reserve(const struct gb_message *req,
+							     size_t max_payload_len)
+{
+	return gb_message_alloc(max_payload_len, GB_RESPONSE(req->header.type),
+				req->header.operation_id, GB_OP_SUCCESS);
+}
+
+/**
+ * Set the final payload length of a response reserved with gb_message_response_reserve.
+ *
+ * The memory of the unused part is released with the message.
+ *
+ * @param resp: reserved response
+ * @param payload_len: payload length. Must not exceed the reserved length.
+ */
+static inline void gb_message_response_commit(struct gb_message *resp, size_t payload_len)
+{
+	__ASSERT_NO_MSG(payload_len <= gb_message_payload_len(resp));
+
+	resp->header.size = sys_cpu_to_le16(sizeof(struct gb_operation_msg_hdr) + payload_len);
+}
+
 /*
  * Allocate a greybus response message
  *
@@ -187,7 +246,11 @@ static inline struct gb_message *gb_message_response_alloc(const void *payload,
 {
 	struct gb_message *msg =
 		gb_message_alloc(payload_len, GB_RESPONSE(request_type), operation_id, status);
-	memcpy(msg->payload, payload, payload_len);
+
+	if (msg) {
+		memcpy(msg->payload, payload, payload_len);
+	}
+
 	return msg;
 }
 
@@ -217,6 +280,8 @@ static inline struct gb_message *gb_message_response_alloc_from_req(const void *
  * Helper to create copy of greybus message.
  *
  * @parm msg
+ *
+ * @return copy of the message, or NULL if it could not be allocated.
  */
 static inline struct gb_message *gb_message_copy(const struct gb_message *msg)
 {
@@ -224,6 +289,10 @@ static inline struct gb_message *gb_message_copy(const struct gb_message *msg)
 	struct gb_message *resp = gb_message_alloc(payload_len, gb_message_type(msg),
 						   msg->header.operation_id, msg->header.result);
 
+	if (!resp) {
+		return NULL;
+	}
+
 	memcpy(resp->payload, msg->payload, payload_len);
 
 	return resp;
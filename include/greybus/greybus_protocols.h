@@ -2181,4 +2181,82 @@ struct gb_log_send_log_request {
 #define GB_VIBRATOR_TYPE_ON  0x02
 #define GB_VIBRATOR_TYPE_OFF 0x03
 
+/* Node Telemetry (vendor protocol) */
+
+#define GB_TELEMETRY_VERSION 0x01
+
+/* operations */
+#define GB_TELEMETRY_TYPE_SUMMARY 0x02
+#define GB_TELEMETRY_TYPE_CPORTS  0x03
+#define GB_TELEMETRY_TYPE_THREADS 0x04
+
+/* Bucket 0 is below 1 us, bucket i is [2^(i - 1), 2^i) us, the last one is unbounded */
+#define GB_TELEMETRY_LATENCY_BUCKETS 16
+
+struct gb_telemetry_pool {
+	__le32 block_size; /* 0 for heap fallback */
+	__le32 blocks;
+	__le32 used;
+	__le32 peak;
+	__le32 failures;
+} __packed;
+
+/* summary response: request has no payload */
+struct gb_telemetry_summary_response {
+	__u8 version;
+	__u8 latency_buckets;
+	__le16 cport_count;
+	__u8 pool_count;
+	__u8 pad[3];
+	__le32 uptime_ms;
+	__le32 heap_size;
+	__le32 heap_used;
+	__le32 heap_peak;
+	__le32 heap_free;
+	__le32 heap_waits;
+	__le32 queue_latency[GB_TELEMETRY_LATENCY_BUCKETS];
+	__le32 handler_latency[GB_TELEMETRY_LATENCY_BUCKETS];
+	struct gb_telemetry_pool pools[];
+} __packed;
+
+/* cport counters, the response can hold fewer cports than requested */
+struct gb_telemetry_cports_request {
+	__le16 first;
+	__le16 count;
+} __packed;
+
+struct gb_telemetry_cport {
+	__le32 rx_requests;
+	__le32 rx_responses;
+	__le32 rx_errors;
+	__le32 tx_requests;
+	__le32 tx_responses;
+	__le32 tx_errors;
+	__le64 rx_bytes;
+	__le64 tx_bytes;
+	__le16 queue_depth;
+	__le16 queue_peak;
+} __packed;
+
+struct gb_telemetry_cports_response {
+	__le16 first;
+	__le16 count;
+	struct gb_telemetry_cport cports[];
+} __packed;
+
+/* thread cpu usage response: request has no payload */
+struct gb_telemetry_thread {
+	__le64 cycles;
+	char name[12]; /* NUL padded, not always NUL-terminated */
+} __packed;
+
+struct gb_telemetry_threads_response {
+	__le32 cycles_per_sec;
+	__le16 count;
+	__le16 pad;
+	__le64 busy_cycles; /* non-idle cycles of all threads */
+	__le64 total_cycles;
+	struct gb_telemetry_thread threads[];
+} __packed;
+
 #endif /* __GREYBUS_PROTOCOLS_H */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GREYBUS_STATS_H_
+#define _GREYBUS_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <greybus/greybus_messages.h>
+
+/* Number of distinct gb_operation_result values counted */
+#define GB_STATS_RESULT_COUNT 11
+
+/**
+ * Map a gb_operation_result to an index in gb_stats_cport.tx_results. Unknown values are counted
+ * as GB_OP_UNKNOWN_ERROR.
+ */
+static inline size_t gb_stats_result_idx(uint8_t result)
+{
+	if (result <= GB_OP_NONEXISTENT) {
+		return result;
+	}
+
+	return result == GB_OP_INTERNAL ? GB_STATS_RESULT_COUNT - 1 : GB_STATS_RESULT_COUNT - 2;
+}
+
+/*
+ * struct gb_stats_cport: Traffic of a cport
+ *
+ * @rx_requests: requests received
+ * @rx_responses: responses received
+ * @rx_errors: responses received with a result other than GB_OP_SUCCESS
+ * @rx_refused: requests refused because the cport or the node was busy
+ * @tx_requests: requests sent
+ * @tx_responses: responses sent
+ * @tx_results: responses sent, indexed by gb_stats_result_idx() of their result
+ * @rx_bytes: bytes received, including headers
+ * @tx_bytes: bytes sent, including headers
+ * @queue_depth: messages waiting to be processed
+ * @queue_peak: maximum value of queue_depth
+ */
+struct gb_stats_cport {
+	uint32_t rx_requests;
+	uint32_t rx_responses;
+	uint32_t rx_errors;
+	uint32_t rx_refused;
+	uint32_t tx_requests;
+	uint32_t tx_responses;
+	uint32_t tx_results[GB_STATS_RESULT_COUNT];
+	uint64_t rx_bytes;
+	uint64_t tx_bytes;
+	uint32_t queue_depth;
+	uint32_t queue_peak;
+};
+
+/* Number of buckets of the dispatch latency histograms */
+#define GB_STATS_LATENCY_BUCKETS 16
+
+/*
+ * struct gb_stats_latency: Dispatch latency histograms, over all cports
+ *
+ * Bucket 0 counts latencies below 1 us, bucket i counts latencies in [2^(i - 1), 2^i) us, and the
+ * last bucket also counts everything longer.
+ *
+ * @queue: time between a message being queued by the transport and picked up by a worker
+ * @handler: time spent processing a message, including sending its response
+ */
+struct gb_stats_latency {
+	uint32_t queue[GB_STATS_LATENCY_BUCKETS];
+	uint32_t handler[GB_STATS_LATENCY_BUCKETS];
+};
+
+/*
+ * struct gb_stats_heap: Usage of the greybus heap
+ *
+ * @size: total size in bytes
+ * @used: bytes currently allocated
+ * @peak: maximum value of used
+ * @free: bytes currently free. Below size - used because of the heap bookkeeping.
+ * @waits: allocations which had to wait for memory to be freed
+ */
+struct gb_stats_heap {
+	size_t size;
+	size_t used;
+	size_t peak;
+	size_t free;
+	uint32_t waits;
+};
+
+/**
+ * Get traffic counters of a cport.
+ *
+ * @param cport
+ * @param stats: output
+ *
+ * @return 0 in case of success.
+ * @return -EINVAL if cport does not exist.
+ */
+int gb_stats_cport_get(uint16_t cport, struct gb_stats_cport *stats);
+
+/**
+ * Get usage of the greybus heap.
+ *
+ * @param stats: output
+ */
+void gb_stats_heap_get(struct gb_stats_heap *stats);
+
+/**
+ * Get the dispatch latency histograms.
+ *
+ * @param stats: output
+ */
+void gb_stats_latency_get(struct gb_stats_latency *stats);
+
+/**
+ * Reset all counters and peaks.
+ */
+void gb_stats_reset(void);
+
+#endif // _GREYBUS_STATS_H_
@@ -62,14 +62,7 @@ static void gb_control_get_manifest_size(uint16_t cport, struct gb_message *req)
 
 static void gb_control_get_manifest(uint16_t cport, struct gb_message *req)
 {
-	struct gb_message *msg = gb_message_alloc(manifest_size(), GB_RESPONSE(req->header.type),
-						  req->header.operation_id, GB_OP_SUCCESS);
-
-	manifest_create(msg->payload, manifest_size());
-
-	gb_transport_message_send(msg, cport);
-
-	gb_message_dealloc(msg);
+	gb_transport_message_response_success_send(req, manifest_get(), manifest_size(), cport);
 }
 
 static void gb_control_connected(uint16_t cport, struct gb_message *req)
@@ -99,13 +92,14 @@ static void gb_control_connected(uint16_t cport, struct gb_message *req)
 	return gb_transport_message_empty_response_send(req, GB_OP_SUCCESS, cport);
 
 error_notify:
-	gb_stop_listening(cport);
+	gb_stop_listening(target_cport);
 	gb_transport_message_empty_response_send(req, gb_errno_to_op_result(retval), cport);
 }
 
 static void gb_control_disconnected(uint16_t cport, struct gb_message *req)
 {
 	int retval;
+	uint16_t target_cport;
 	const struct gb_control_disconnected_request *req_data =
 		(const struct gb_control_disconnected_request *)req->payload;
 
@@ -114,7 +108,8 @@ static void gb_control_disconnected(uint16_t cport, struct gb_message *req)
 		return gb_transport_message_empty_response_send(req, GB_OP_INVALID, cport);
 	}
 
-	retval = gb_notify(sys_le16_to_cpu(req_data->cport_id), GB_EVT_DISCONNECTED);
+	target_cport = sys_le16_to_cpu(req_data->cport_id);
+	retval = gb_notify(target_cport, GB_EVT_DISCONNECTED);
 	if (retval) {
 		LOG_ERR("Cannot notify GB driver of disconnect event.");
 		/*
@@ -123,9 +118,9 @@ static void gb_control_disconnected(uint16_t cport, struct gb_message *req)
 		 */
 	}
 
-	retval = gb_stop_listening(cport);
+	retval = gb_stop_listening(target_cport);
 	if (retval) {
-		LOG_ERR("Can not disconnect cport %d: error %d", cport, retval);
+		LOG_ERR("Can not disconnect cport %d: error %d", target_cport, retval);
 	}
 
 	gb_transport_message_empty_response_send(req, gb_errno_to_op_result(retval), cport);
@@ -12,6 +12,7 @@
 #include <greybus-utils/manifest.h>
 #include <zephyr/logging/log.h>
 #include "greybus_internal.h"
+#include "greybus_operation.h"
 
 LOG_MODULE_REGISTER(greybus_fw_download, CONFIG_GREYBUS_LOG_LEVEL);
 
@@ -32,9 +33,14 @@ struct fw_fetch_req {
 	struct gb_fw_download_fetch_firmware_request req;
 };
 
+static void gb_fw_download_fetch_firmware_response_handler(uint16_t cport, struct gb_message *resp,
+							   int status, void *priv);
+static void gb_fw_download_early_fail(uint16_t cport, u8 firmware_id, uint8_t req_id);
+
 static void gb_fw_download_fetch_firmware(uint16_t cport, uint8_t id, uint16_t offset,
 					  uint16_t size)
 {
+	int ret;
 	const struct fw_fetch_req req = {
 		.hdr =
 			{
@@ -52,19 +58,32 @@ static void gb_fw_download_fetch_firmware(uint16_t cport, uint8_t id, uint16_t o
 			},
 	};
 
-	gb_transport_message_send((const struct gb_message *)&req, cport);
+	ret = gb_transport_message_request_send((const struct gb_message *)&req, cport,
+						gb_fw_download_fetch_firmware_response_handler,
+						NULL, GB_OPERATION_TIMEOUT_DEFAULT);
+	if (ret < 0) {
+		LOG_ERR("Failed to send fetch firmware request: %d", ret);
+		gb_fw_download_early_fail(cport, id, priv_data.req_id);
+		priv_data.req_id = -1;
+	}
 }
 
-static void gb_fw_download_find_firmware_response_handler(uint16_t cport, struct gb_message *resp)
+static void gb_fw_download_find_firmware_response_handler(uint16_t cport, struct gb_message *resp,
+							  int status, void *priv)
 {
-	const struct gb_fw_download_find_firmware_response *resp_data =
-		(const struct gb_fw_download_find_firmware_response *)resp->payload;
+	const struct gb_fw_download_find_firmware_response *resp_data;
 
-	if (!gb_message_is_success(resp)) {
+	ARG_UNUSED(priv);
+
+	if (status < 0 || !gb_message_is_success(resp)) {
 		LOG_ERR("Find firmware request failed");
+		gb_fw_mgmt_interface_fw_loaded(priv_data.req_id, GB_FW_LOAD_STATUS_FAILED, 0, 0);
+		priv_data.req_id = -1;
 		return gb_message_dealloc(resp);
 	}
 
+	resp_data = (const struct gb_fw_download_find_firmware_response *)resp->payload;
+
 	flash_img_init(&priv_data.ctx);
 	priv_data.fw_id = resp_data->firmware_id;
 	priv_data.fw_size = resp_data->size;
@@ -72,7 +91,7 @@ static void gb_fw_download_find_firmware_response_handler(uint16_t cport, struct
 
 	gb_message_dealloc(resp);
 
-	gb_fw_download_fetch_firmware(cport, resp_data->firmware_id, 0, DATA_SIZE_MAX);
+	gb_fw_download_fetch_firmware(cport, priv_data.fw_id, 0, DATA_SIZE_MAX);
 }
 
 static void gb_fw_release_firmware(uint16_t cport, u8 firmware_id)
@@ -85,8 +104,7 @@ static void gb_fw_release_firmware(uint16_t cport, u8 firmware_id)
 
 	req_data->firmware_id = firmware_id;
 
-	gb_transport_message_send(req, cport);
-	gb_message_dealloc(req);
+	gb_transport_message_send_consume(req, cport);
 }
 
 static void gb_fw_download_early_fail(uint16_t cport, u8 firmware_id, uint8_t req_id)
@@ -116,13 +134,23 @@ static void gb_fw_download_fetch_final(uint16_t cport, u8 firmware_id, uint8_t r
 				       hdr.h.v1.sem_ver.minor);
 }
 
-static void gb_fw_download_fetch_firmware_response_handler(uint16_t cport, struct gb_message *resp)
+static void gb_fw_download_fetch_firmware_response_handler(uint16_t cport, struct gb_message *resp,
+							   int status, void *priv)
 {
 	int ret;
 	uint32_t new_data_size;
 	uint32_t cur_data_size = MIN(priv_data.fw_size - priv_data.offset, DATA_SIZE_MAX);
 	bool is_final_write = priv_data.offset + cur_data_size >= priv_data.fw_size;
 
+	ARG_UNUSED(priv);
+
+	if (status < 0) {
+		LOG_ERR("Fetch firmware request timed out");
+		gb_fw_download_early_fail(cport, priv_data.fw_id, priv_data.req_id);
+		priv_data.req_id = -1;
+		return;
+	}
+
 	if (!gb_message_is_success(resp)) {
 		LOG_ERR("Fetch firmware request failed");
 		return gb_message_dealloc(resp);
@@ -141,7 +169,8 @@ static void gb_fw_download_fetch_firmware_response_handler(uint16_t cport, struc
 				       is_final_write);
 	if (ret < 0) {
 		LOG_ERR("Failed to write firmware to flash: %d", ret);
-		gb_fw_download_early_fail(cport, priv_data.fw_id, priv_data.fw_size);
+		gb_fw_download_early_fail(cport, priv_data.fw_id, priv_data.req_id);
+		priv_data.req_id = -1;
 		return gb_message_dealloc(resp);
 	}
 
@@ -160,10 +189,9 @@ static void op_handler(const void *priv, struct gb_message *msg, uint16_t cport)
 	ARG_UNUSED(priv);
 
 	switch (gb_message_type(msg)) {
+	/* Responses arriving after their operation timed out */
 	case GB_RESPONSE(GB_FW_DOWNLOAD_TYPE_FIND_FIRMWARE):
-		return gb_fw_download_find_firmware_response_handler(cport, msg);
 	case GB_RESPONSE(GB_FW_DOWNLOAD_TYPE_FETCH_FIRMWARE):
-		return gb_fw_download_fetch_firmware_response_handler(cport, msg);
 	case GB_RESPONSE(GB_FW_DOWNLOAD_TYPE_RELEASE_FIRMWARE):
 		return gb_message_dealloc(msg);
 	default:
@@ -177,6 +205,7 @@ const struct gb_driver gb_fw_download_driver = {
 
 void gb_fw_download_find_firmware(uint8_t req_id, const char *firmware_tag)
 {
+	int ret;
 	struct gb_message *req =
 		gb_message_request_alloc(sizeof(struct gb_fw_download_find_firmware_request),
 					 GB_FW_DOWNLOAD_TYPE_FIND_FIRMWARE, false);
@@ -186,6 +215,14 @@ void gb_fw_download_find_firmware(uint8_t req_id, const char *firmware_tag)
 	priv_data.req_id = req_id;
 	strncpy(req_data->firmware_tag, firmware_tag, sizeof(req_data->firmware_tag));
 
-	gb_transport_message_send(req, GREYBUS_FW_DOWNLOAD_CPORT);
+	ret = gb_transport_message_request_send(req, GREYBUS_FW_DOWNLOAD_CPORT,
+						gb_fw_download_find_firmware_response_handler,
+						NULL, GB_OPERATION_TIMEOUT_DEFAULT);
+	if (ret < 0) {
+		LOG_ERR("Failed to send find firmware request: %d", ret);
+		gb_fw_mgmt_interface_fw_loaded(req_id, GB_FW_LOAD_STATUS_FAILED, 0, 0);
+		priv_data.req_id = -1;
+	}
+
 	gb_message_dealloc(req);
 }
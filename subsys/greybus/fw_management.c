@@ -83,6 +83,5 @@ void gb_fw_mgmt_interface_fw_loaded(uint8_t id, uint8_t status, uint16_t major,
 	req_data->major = sys_cpu_to_le16(major);
 	req_data->minor = sys_cpu_to_le16(minor);
 
-	gb_transport_message_send(msg, GREYBUS_FW_MANAGEMENT_CPORT);
-	gb_message_dealloc(msg);
+	gb_transport_message_send_consume(msg, GREYBUS_FW_MANAGEMENT_CPORT);
 }
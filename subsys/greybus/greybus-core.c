@@ -35,16 +35,14 @@
 #include "greybus_transport.h"
 #include <greybus-utils/manifest.h>
 #include "greybus_internal.h"
+#include "greybus_dispatch.h"
+#include "greybus_stats_internal.h"
+#include "greybus_trace.h"
 
 LOG_MODULE_REGISTER(greybus, CONFIG_GREYBUS_LOG_LEVEL);
 
-#define GB_PING_TYPE 0x00
-
-/* 2 msg per cport seems to be a good number */
-K_MSGQ_DEFINE(gb_rx_msgq, sizeof(struct gb_msg_with_cport), GREYBUS_CPORT_COUNT * 2, 1);
-
-K_THREAD_STACK_DEFINE(gb_rx_thread_stack, 1280);
-static struct k_thread gb_rx_thread;
+/* Set once gb_init has succeeded, so that gb_deinit only tears down what exists */
+static bool gb_initialized;
 
 uint8_t gb_errno_to_op_result(int err)
 {
@@ -97,64 +95,46 @@ uint8_t gb_errno_to_op_result(int err)
 	}
 }
 
-static void gb_process_msg(struct gb_message *msg, uint16_t cport)
+int greybus_rx_handler(uint16_t cport, struct gb_message *msg)
 {
+	int ret;
 	const struct gb_cport *cport_ptr = gb_cport_get(cport);
 
-	if (gb_message_type(msg) == GB_PING_TYPE) {
-		return gb_transport_message_empty_response_send(msg, GB_OP_SUCCESS, cport);
+	if (!cport_ptr || !cport_ptr->driver || !cport_ptr->driver->op_handler) {
+		LOG_ERR("Cport %u does not have a valid driver registered", cport);
+		gb_message_dealloc(msg);
+		return 0;
 	}
+	// LOG_HEXDUMP_DBG(data, size, "RX: ");
 
-	cport_ptr->driver->op_handler(cport_ptr->priv, msg, cport);
-}
-
-static void gb_pending_message_worker(void *p1, void *p2, void *p3)
-{
-	ARG_UNUSED(p1);
-	ARG_UNUSED(p2);
-	ARG_UNUSED(p3);
-
-	int ret;
-	struct gb_msg_with_cport msg;
-
-	while (1) {
-		ret = k_msgq_get(&gb_rx_msgq, &msg, K_FOREVER);
-		if (ret < 0) {
-			continue;
-		}
-
-		LOG_DBG("CPort: %d, Type: %d, Result: %d, Id: %u", msg.cport,
-			gb_message_type(msg.msg), msg.msg->header.result,
-			msg.msg->header.operation_id);
+	gb_stats_rx(cport, &msg->header);
+	gb_trace(GB_TRACE_RX_ENQUEUE, cport, &msg->header);
 
-		gb_process_msg(msg.msg, msg.cport);
+	ret = gb_dispatch_submit(cport, msg);
+	if (ret != -EBUSY) {
+		return ret;
 	}
-}
 
-int greybus_rx_handler(uint16_t cport, struct gb_message *msg)
-{
-	const struct gb_driver *drv;
-	const struct gb_msg_with_cport item = {
-		.cport = cport,
-		.msg = msg,
-	};
-
-	drv = gb_cport_get(cport)->driver;
-	if (!drv || !drv->op_handler) {
-		LOG_ERR("Cport %u does not have a valid driver registered", cport);
+	gb_stats_rx_refused(cport);
+
+	/* Unidirectional requests have no response to carry the retry */
+	if (msg->header.operation_id == 0) {
+		LOG_DBG("Cport %u busy, dropping unidirectional request", cport);
 		gb_message_dealloc(msg);
 		return 0;
 	}
-	// LOG_HEXDUMP_DBG(data, size, "RX: ");
 
-	k_msgq_put(&gb_rx_msgq, &item, K_FOREVER);
+	LOG_DBG("Cport %u busy, asking to retry", cport);
+	gb_transport_message_empty_response_send(msg, gb_errno_to_op_result(ret), cport);
 
 	return 0;
 }
 
 int gb_listen(uint16_t cport)
 {
-	const struct gb_transport_backend *transport = gb_transport_get_backend();
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+	int ret;
+#endif // CONFIG_GREYBUS_XPORT_MULTI
 	const struct gb_cport *cport_ptr = gb_cport_get(cport);
 
 	if (!cport_ptr) {
@@ -167,12 +147,19 @@ int gb_listen(uint16_t cport)
 		return -EINVAL;
 	}
 
-	return transport->listen(cport);
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+	ret = gb_transport_bind(cport, cport_ptr->transport);
+	if (ret < 0) {
+		return ret;
+	}
+#endif // CONFIG_GREYBUS_XPORT_MULTI
+
+	return gb_transport_get_backend(cport)->listen(cport);
 }
 
 int gb_stop_listening(uint16_t cport)
 {
-	const struct gb_transport_backend *transport = gb_transport_get_backend();
+	const struct gb_transport_backend *transport = gb_transport_get_backend(cport);
 	const struct gb_cport *cport_ptr = gb_cport_get(cport);
 
 	if (!cport_ptr) {
@@ -196,35 +183,52 @@ int gb_init(const struct gb_transport_backend *transport)
 		return -EINVAL;
 	}
 
+	if (gb_initialized) {
+		return -EALREADY;
+	}
+
 	ret = gb_cports_init();
 	if (ret < 0) {
 		return ret;
 	}
 
-	k_thread_create(&gb_rx_thread, gb_rx_thread_stack,
-			K_THREAD_STACK_SIZEOF(gb_rx_thread_stack), gb_pending_message_worker, NULL,
-			NULL, NULL, 5, 0, K_NO_WAIT);
+	ret = manifest_init();
+	if (ret < 0) {
+		gb_cports_deinit();
+		return ret;
+	}
+
+	ret = gb_dispatch_init();
+	if (ret < 0) {
+		gb_cports_deinit();
+		return ret;
+	}
 
-	transport->init();
+	ret = gb_transport_init(transport);
+	if (ret < 0) {
+		gb_dispatch_deinit();
+		gb_cports_deinit();
+		return ret;
+	}
+
+	gb_initialized = true;
 
 	return 0;
 }
 
 void gb_deinit(void)
 {
-	const struct gb_transport_backend *transport = gb_transport_get_backend();
-
-	if (!transport) {
+	if (!gb_initialized) {
 		return; /* gb not initialized */
 	}
 
-	k_thread_abort(&gb_rx_thread);
+	gb_dispatch_deinit();
 
 	gb_cports_deinit();
 
-	if (transport->exit) {
-		transport->exit();
-	}
+	gb_transport_exit();
+
+	gb_initialized = false;
 }
 
 int gb_notify(uint16_t cport, enum gb_event event)
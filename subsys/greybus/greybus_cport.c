@@ -17,6 +17,7 @@
 #include "greybus_fw_mgmt.h"
 #include "greybus_internal.h"
 #include "greybus_raw_internal.h"
+#include "greybus_transport.h"
 
 LOG_MODULE_REGISTER(greybus_cport, CONFIG_GREYBUS_LOG_LEVEL);
 
@@ -24,6 +25,7 @@ extern const struct gb_driver gb_control_driver;
 extern const struct gb_driver gb_i2c_driver;
 extern const struct gb_driver gb_loopback_driver;
 extern const struct gb_driver gb_log_driver;
+extern const struct gb_driver gb_telemetry_driver;
 extern const struct gb_driver gb_vibrator_driver;
 
 /* Reset the counter to 0 */
@@ -98,16 +100,49 @@ DT_FOREACH_CHILD_STATUS_OKAY(_GREYBUS_BASE_NODE, GB_PRIV_DATA_HANDLER)
 
 #define GB_CPORT_SPI_PRIV_DATA(_node_id, _prop, _idx) &gb_spi_priv_data_##_idx
 
-#define GB_CPORT(_priv, _bundle, _protocol, _driver)                                               \
+/* Control first, then protocols with small and latency sensitive operations, then the rest */
+#define GB_CPORT_PRIORITY_DEFAULT(_protocol)                                                       \
+	((_protocol) == GREYBUS_PROTOCOL_CONTROL ? GB_CPORT_PRIORITY_CONTROL                       \
+	 : ((_protocol) == GREYBUS_PROTOCOL_GPIO || (_protocol) == GREYBUS_PROTOCOL_I2C ||         \
+	    (_protocol) == GREYBUS_PROTOCOL_UART || (_protocol) == GREYBUS_PROTOCOL_PWM ||         \
+	    (_protocol) == GREYBUS_PROTOCOL_LIGHTS || (_protocol) == GREYBUS_PROTOCOL_VIBRATOR ||  \
+	    (_protocol) == GREYBUS_PROTOCOL_LOG || (_protocol) == GREYBUS_PROTOCOL_VENDOR)         \
+		 ? GB_CPORT_PRIORITY_INTERACTIVE                                                   \
+		 : GB_CPORT_PRIORITY_BULK)
+
+/* Bundles can override the default priority of their cports */
+#define GB_CPORT_PRIORITY_DT(_node_id, _protocol)                                                  \
+	COND_CODE_1(DT_NODE_HAS_PROP(_node_id, dispatch_priority),                                 \
+		    (DT_ENUM_IDX(_node_id, dispatch_priority)),                                    \
+		    (GB_CPORT_PRIORITY_DEFAULT(_protocol)))
+
+/* Bundles can move their cports to another transport, when several are enabled */
+#define GB_CPORT_TRANSPORT_DT(_node_id)                                                            \
+	COND_CODE_1(DT_NODE_HAS_PROP(_node_id, transport), (DT_ENUM_IDX(_node_id, transport)),     \
+		    (GB_TRANSPORT_DEFAULT))
+
+#define GB_CPORT_WITH_TRANSPORT(_priv, _bundle, _protocol, _driver, _priority, _transport)         \
 	{                                                                                          \
 		.bundle = _bundle,                                                                 \
 		.protocol = _protocol,                                                             \
+		.priority = _priority,                                                             \
 		.priv = _priv,                                                                     \
 		.driver = _driver,                                                                 \
+		IF_ENABLED(CONFIG_GREYBUS_XPORT_MULTI, (.transport = _transport,))                 \
 	}
 
+#define GB_CPORT(_priv, _bundle, _protocol, _driver)                                               \
+	GB_CPORT_WITH_TRANSPORT(_priv, _bundle, _protocol, _driver,                                \
+				GB_CPORT_PRIORITY_DEFAULT(_protocol), GB_TRANSPORT_DEFAULT)
+
+/* Cport of a devicetree bundle */
+#define GB_CPORT_DT(_node_id, _priv, _bundle, _protocol, _driver)                                  \
+	GB_CPORT_WITH_TRANSPORT(_priv, _bundle, _protocol, _driver,                                \
+				GB_CPORT_PRIORITY_DT(_node_id, _protocol),                         \
+				GB_CPORT_TRANSPORT_DT(_node_id))
+
 #define _GB_CPORT(_node_id, _prop, _idx, _bundle, _protocol, _driver, PRIV_FN)                     \
-	GB_CPORT(PRIV_FN(_node_id, _prop, _idx), _bundle, _protocol, _driver)
+	GB_CPORT_DT(_node_id, PRIV_FN(_node_id, _prop, _idx), _bundle, _protocol, _driver)
 
 #define GREYBUS_CPORTS_IN_BRIDGED_PHY_BUNDLE(_node_id, _bundle)                                    \
 	FOR_EACH_NONEMPTY_TERM(                                                                    \
@@ -136,8 +171,9 @@ DT_FOREACH_CHILD_STATUS_OKAY(_GREYBUS_BASE_NODE, GB_PRIV_DATA_HANDLER)
 						       &gb_i2c_driver, GB_CPORT_DEV_PRIV_DATA))))
 
 #define GREYBUS_CPORT_IN_LIGHTS(_node_id, _bundle)                                                 \
-	IF_ENABLED(CONFIG_GREYBUS_LIGHTS, (GB_CPORT(&gb_lights_priv_data, _bundle,                 \
-						    GREYBUS_PROTOCOL_LIGHTS, &gb_lights_driver)))
+	IF_ENABLED(CONFIG_GREYBUS_LIGHTS,                                                          \
+		   (GB_CPORT_DT(_node_id, &gb_lights_priv_data, _bundle, GREYBUS_PROTOCOL_LIGHTS,  \
+				&gb_lights_driver)))
 
 #define GREYBUS_CPORT_IN_VIBRATORS(_node_id, _bundle)                                              \
 	IF_ENABLED(CONFIG_GREYBUS_VIBRATOR,                                                        \
@@ -188,6 +224,9 @@ static struct gb_cport cports[] = {
 #ifdef CONFIG_GREYBUS_LOOPBACK
 	GB_CPORT(NULL, LOCAL_COUNTER, GREYBUS_PROTOCOL_LOOPBACK, &gb_loopback_driver),
 #endif // CONFIG_GREYBUS_LOOPBACK
+#ifdef CONFIG_GREYBUS_TELEMETRY
+	GB_CPORT(NULL, LOCAL_COUNTER, GREYBUS_PROTOCOL_VENDOR, &gb_telemetry_driver),
+#endif // CONFIG_GREYBUS_TELEMETRY
 	DT_FOREACH_CHILD_STATUS_OKAY(_GREYBUS_BASE_NODE, GB_CPORTS_BUNDLE_WRAPPER)};
 
 BUILD_ASSERT(GREYBUS_CPORT_COUNT == ARRAY_SIZE(cports));
@@ -9,11 +9,28 @@
 
 #include <greybus/greybus.h>
 
+/*
+ * enum gb_cport_priority: Dispatch priority class of a cport. Lower values are served first.
+ *
+ * Matches the order of the dispatch-priority devicetree property of greybus bundles.
+ */
+enum gb_cport_priority {
+	GB_CPORT_PRIORITY_CONTROL,
+	GB_CPORT_PRIORITY_INTERACTIVE,
+	GB_CPORT_PRIORITY_BULK,
+	GB_CPORT_PRIORITY_COUNT,
+};
+
 struct gb_cport {
 	const struct gb_driver *driver;
 	const void *priv;
 	uint8_t bundle;
 	uint8_t protocol;
+	uint8_t priority;
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+	/* enum gb_transport_id the cport is bound to when connected */
+	uint8_t transport;
+#endif // CONFIG_GREYBUS_XPORT_MULTI
 };
 
 const struct gb_cport *gb_cport_get(uint16_t cport);
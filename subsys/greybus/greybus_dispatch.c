@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pool of workers processing inbound greybus messages.
+ *
+ * Each cport has a small queue of pending messages. A cport with pending messages is placed in the
+ * ready list of its priority class, and is owned by a single worker while one of its messages is
+ * being processed. Thus, messages on a cport are handled strictly in order, while a slow operation
+ * on one cport does not stall the others.
+ *
+ * A driver can defer the completion of a request, to wait for a bus transaction without blocking
+ * a worker. The cport stays owned, and thus receives no further message, until the driver
+ * completes the operation.
+ *
+ * Workers serve the highest priority class with pending messages first. A lower class which has
+ * been passed over CONFIG_GREYBUS_DISPATCH_AGING times is served next, so bulk traffic is delayed
+ * but never starved.
+ *
+ * Requests are never waited for. A request which finds its cport queue full, or the node over its
+ * total budget of pending messages, is refused so that the transport can carry on with other
+ * cports. Part of the budget is kept for the control cport. Responses can not be refused, and wait
+ * for space in their cport queue instead.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/slist.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_cport.h"
+#include "greybus_dispatch.h"
+#include "greybus_internal.h"
+#include "greybus_operation.h"
+#include "greybus_stats_internal.h"
+#include "greybus_trace.h"
+#include "greybus_transport.h"
+
+LOG_MODULE_REGISTER(greybus_dispatch, CONFIG_GREYBUS_LOG_LEVEL);
+
+#define GB_PING_TYPE 0x00
+
+/*
+ * struct gb_dispatch_queue: Pending messages of a cport
+ *
+ * @node: entry in the ready list
+ * @space: number of free slots in the queue, limited to the queue depth of the driver
+ * @msgs: ring of pending messages
+ * @stamps: cycle count at which each message in msgs was queued
+ * @head: index of the oldest pending message
+ * @count: number of pending messages
+ * @peak: maximum value of count since the last reset
+ * @priority: priority class of the cport
+ * @scheduled: true if the cport is in the ready list, owned by a worker or deferred
+ * @in_handler: true while a worker runs the driver for the cport
+ * @deferred: true if the driver deferred the completion of the current request
+ */
+struct gb_dispatch_queue {
+	sys_snode_t node;
+	struct k_sem space;
+	struct gb_message *msgs[CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH];
+#ifdef CONFIG_GREYBUS_STATS
+	uint32_t stamps[CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH];
+#endif // CONFIG_GREYBUS_STATS
+	uint8_t head;
+	uint8_t count;
+	uint8_t peak;
+	uint8_t priority;
+	bool scheduled;
+	bool in_handler;
+	bool deferred;
+};
+
+static struct gb_dispatch_queue queues[GREYBUS_CPORT_COUNT];
+
+BUILD_ASSERT(CONFIG_GREYBUS_DISPATCH_CONTROL_RESERVE < CONFIG_GREYBUS_DISPATCH_MAX_PENDING,
+	     "Control cport reserve leaves no room for other cports");
+
+/* Number of queued messages over all cports */
+static uint32_t pending;
+
+/* Cports which have pending messages and are not owned by any worker, per priority class */
+static sys_slist_t ready_lists[GB_CPORT_PRIORITY_COUNT];
+/* Number of times each class was passed over for a higher one since it was last served */
+static uint8_t passed_over[GB_CPORT_PRIORITY_COUNT];
+static struct k_spinlock ready_lock;
+static K_SEM_DEFINE(ready_sem, 0, K_SEM_MAX_LIMIT);
+
+K_THREAD_STACK_ARRAY_DEFINE(gb_dispatch_stacks, CONFIG_GREYBUS_DISPATCH_WORKERS,
+			    CONFIG_GREYBUS_DISPATCH_STACK_SIZE);
+static struct k_thread gb_dispatch_threads[CONFIG_GREYBUS_DISPATCH_WORKERS];
+
+static void gb_process_msg(struct gb_message *msg, uint16_t cport)
+{
+	const struct gb_cport *cport_ptr = gb_cport_get(cport);
+	/* Driver owns the message once called */
+	const struct gb_operation_msg_hdr hdr = msg->header;
+
+	if (gb_message_is_response(msg) && gb_operation_response_handle(cport, msg)) {
+		return;
+	}
+
+	if (gb_message_type(msg) == GB_PING_TYPE) {
+		return gb_transport_message_empty_response_send(msg, GB_OP_SUCCESS, cport);
+	}
+
+	gb_trace(GB_TRACE_HANDLER_ENTRY, cport, &hdr);
+	cport_ptr->driver->op_handler(cport_ptr->priv, msg, cport);
+	gb_trace(GB_TRACE_HANDLER_EXIT, cport, &hdr);
+}
+
+static struct gb_message *gb_dispatch_queue_pop(struct gb_dispatch_queue *q)
+{
+	struct gb_message *msg = q->msgs[q->head];
+
+	q->head = (q->head + 1) % ARRAY_SIZE(q->msgs);
+	q->count--;
+	pending--;
+
+	return msg;
+}
+
+/* Pick the next cport to serve. Must be called with ready_lock held, and a cport ready. */
+static struct gb_dispatch_queue *gb_dispatch_ready_get(void)
+{
+	size_t i, class = GB_CPORT_PRIORITY_COUNT;
+
+	for (i = 0; i < ARRAY_SIZE(ready_lists); i++) {
+		if (sys_slist_is_empty(&ready_lists[i])) {
+			continue;
+		}
+
+		if (class == GB_CPORT_PRIORITY_COUNT) {
+			class = i;
+		} else if (passed_over[i] >= CONFIG_GREYBUS_DISPATCH_AGING) {
+			class = i;
+			break;
+		}
+	}
+
+	passed_over[class] = 0;
+	for (i = class + 1; i < ARRAY_SIZE(ready_lists); i++) {
+		if (!sys_slist_is_empty(&ready_lists[i])) {
+			passed_over[i]++;
+		}
+	}
+
+	return CONTAINER_OF(sys_slist_get_not_empty(&ready_lists[class]), struct gb_dispatch_queue,
+			    node);
+}
+
+/*
+ * Give up ownership of a cport. Must be called with ready_lock held.
+ *
+ * @return true if the cport has pending messages, and a worker needs to be woken up.
+ */
+static bool gb_dispatch_release(struct gb_dispatch_queue *q)
+{
+	if (q->count == 0) {
+		q->scheduled = false;
+		return false;
+	}
+
+	/* Put the cport at the back of the ready list so other cports get a turn */
+	sys_slist_append(&ready_lists[q->priority], &q->node);
+
+	return true;
+}
+
+static void gb_dispatch_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	bool requeue;
+	uint16_t cport;
+	uint32_t queued = 0, start;
+	k_spinlock_key_t key;
+	struct gb_message *msg;
+	struct gb_dispatch_queue *q;
+
+	while (1) {
+		k_sem_take(&ready_sem, K_FOREVER);
+
+		key = k_spin_lock(&ready_lock);
+		q = gb_dispatch_ready_get();
+#ifdef CONFIG_GREYBUS_STATS
+		queued = q->stamps[q->head];
+#endif // CONFIG_GREYBUS_STATS
+		msg = gb_dispatch_queue_pop(q);
+		q->in_handler = true;
+		k_spin_unlock(&ready_lock, key);
+
+		k_sem_give(&q->space);
+		cport = q - queues;
+
+		gb_trace(GB_TRACE_WORKER_DEQUEUE, cport, &msg->header);
+
+		LOG_DBG("CPort: %d, Type: %d, Result: %d, Id: %u", cport, gb_message_type(msg),
+			msg->header.result, msg->header.operation_id);
+
+		start = k_cycle_get_32();
+		gb_process_msg(msg, cport);
+		gb_stats_dispatch(start - queued, k_cycle_get_32() - start);
+
+		key = k_spin_lock(&ready_lock);
+		q->in_handler = false;
+		requeue = !q->deferred && gb_dispatch_release(q);
+		k_spin_unlock(&ready_lock, key);
+
+		if (requeue) {
+			k_sem_give(&ready_sem);
+		}
+	}
+}
+
+/* Number of pending messages above which requests on a cport are refused */
+static uint32_t gb_dispatch_budget(uint16_t cport)
+{
+	if (cport == 0) {
+		return CONFIG_GREYBUS_DISPATCH_MAX_PENDING;
+	}
+
+	return CONFIG_GREYBUS_DISPATCH_MAX_PENDING - CONFIG_GREYBUS_DISPATCH_CONTROL_RESERVE;
+}
+
+int gb_dispatch_submit(uint16_t cport, struct gb_message *msg)
+{
+	int ret;
+	bool kick = false, is_response;
+	k_spinlock_key_t key;
+	struct gb_dispatch_queue *q;
+
+	if (cport >= ARRAY_SIZE(queues)) {
+		return -EINVAL;
+	}
+
+	q = &queues[cport];
+	is_response = gb_message_is_response(msg);
+
+	ret = k_sem_take(&q->space, is_response ? K_FOREVER : K_NO_WAIT);
+	if (ret < 0) {
+		return -EBUSY;
+	}
+
+	key = k_spin_lock(&ready_lock);
+	if (!is_response && pending >= gb_dispatch_budget(cport)) {
+		k_spin_unlock(&ready_lock, key);
+		k_sem_give(&q->space);
+		return -EBUSY;
+	}
+
+	pending++;
+	q->msgs[(q->head + q->count) % ARRAY_SIZE(q->msgs)] = msg;
+#ifdef CONFIG_GREYBUS_STATS
+	q->stamps[(q->head + q->count) % ARRAY_SIZE(q->stamps)] = k_cycle_get_32();
+#endif // CONFIG_GREYBUS_STATS
+	q->count++;
+	q->peak = MAX(q->peak, q->count);
+	if (!q->scheduled) {
+		q->scheduled = true;
+		sys_slist_append(&ready_lists[q->priority], &q->node);
+		kick = true;
+	}
+	k_spin_unlock(&ready_lock, key);
+
+	if (kick) {
+		k_sem_give(&ready_sem);
+	}
+
+	return 0;
+}
+
+int gb_operation_defer(uint16_t cport)
+{
+	int ret = 0;
+	k_spinlock_key_t key;
+	struct gb_dispatch_queue *q;
+
+	if (cport >= ARRAY_SIZE(queues)) {
+		return -EINVAL;
+	}
+
+	q = &queues[cport];
+
+	key = k_spin_lock(&ready_lock);
+	if (q->in_handler && !q->deferred) {
+		q->deferred = true;
+	} else {
+		ret = -EINVAL;
+	}
+	k_spin_unlock(&ready_lock, key);
+
+	return ret;
+}
+
+void gb_operation_complete(uint16_t cport)
+{
+	bool kick = false;
+	k_spinlock_key_t key;
+	struct gb_dispatch_queue *q;
+
+	if (cport >= ARRAY_SIZE(queues)) {
+		return;
+	}
+
+	q = &queues[cport];
+
+	key = k_spin_lock(&ready_lock);
+	if (q->deferred) {
+		q->deferred = false;
+		/* Else the worker is still in the driver, and releases the cport on return */
+		kick = !q->in_handler && gb_dispatch_release(q);
+	}
+	k_spin_unlock(&ready_lock, key);
+
+	if (kick) {
+		k_sem_give(&ready_sem);
+	}
+}
+
+int gb_dispatch_depth_get(uint16_t cport, uint32_t *depth, uint32_t *peak)
+{
+	k_spinlock_key_t key;
+
+	if (cport >= ARRAY_SIZE(queues)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&ready_lock);
+	*depth = queues[cport].count;
+	*peak = queues[cport].peak;
+	k_spin_unlock(&ready_lock, key);
+
+	return 0;
+}
+
+void gb_dispatch_peak_reset(void)
+{
+	size_t i;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ready_lock);
+	for (i = 0; i < ARRAY_SIZE(queues); i++) {
+		queues[i].peak = queues[i].count;
+	}
+	k_spin_unlock(&ready_lock, key);
+}
+
+static uint8_t gb_dispatch_queue_depth(uint16_t cport)
+{
+	const struct gb_cport *cport_ptr = gb_cport_get(cport);
+	const uint8_t depth = cport_ptr->driver ? cport_ptr->driver->queue_depth : 0;
+
+	if (depth == 0 || depth > CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH) {
+		return CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH;
+	}
+
+	return depth;
+}
+
+int gb_dispatch_init(void)
+{
+	size_t i;
+	uint8_t depth;
+
+	for (i = 0; i < ARRAY_SIZE(ready_lists); i++) {
+		sys_slist_init(&ready_lists[i]);
+		passed_over[i] = 0;
+	}
+	k_sem_reset(&ready_sem);
+	pending = 0;
+
+	for (i = 0; i < ARRAY_SIZE(queues); i++) {
+		queues[i].head = 0;
+		queues[i].count = 0;
+		queues[i].peak = 0;
+		queues[i].scheduled = false;
+		queues[i].in_handler = false;
+		queues[i].deferred = false;
+		queues[i].priority = gb_cport_get(i)->priority;
+		depth = gb_dispatch_queue_depth(i);
+		k_sem_init(&queues[i].space, depth, depth);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(gb_dispatch_threads); i++) {
+		k_thread_create(&gb_dispatch_threads[i], gb_dispatch_stacks[i],
+				K_THREAD_STACK_SIZEOF(gb_dispatch_stacks[i]), gb_dispatch_worker,
+				NULL, NULL, NULL, CONFIG_GREYBUS_DISPATCH_THREAD_PRIORITY, 0,
+				K_NO_WAIT);
+		k_thread_name_set(&gb_dispatch_threads[i], "gb_dispatch");
+	}
+
+	return 0;
+}
+
+void gb_dispatch_deinit(void)
+{
+	size_t i;
+	struct gb_dispatch_queue *q;
+
+	for (i = 0; i < ARRAY_SIZE(gb_dispatch_threads); i++) {
+		k_thread_abort(&gb_dispatch_threads[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(queues); i++) {
+		q = &queues[i];
+		while (q->count) {
+			gb_message_dealloc(gb_dispatch_queue_pop(q));
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GREYBUS_DISPATCH_H_
+#define _GREYBUS_DISPATCH_H_
+
+#include <greybus/greybus_messages.h>
+
+/**
+ * Start the dispatch workers.
+ *
+ * @return 0 in case of success.
+ * @return < 0 in case of error.
+ */
+int gb_dispatch_init(void);
+
+/**
+ * Stop the dispatch workers and drop all pending messages.
+ */
+void gb_dispatch_deinit(void);
+
+/**
+ * Queue a message for processing by the driver of the cport.
+ *
+ * Messages on the same cport are processed in the order they were submitted, one at a time.
+ * Messages on different cports can be processed concurrently.
+ *
+ * Requests are refused rather than waited for when the cport queue is full, or too many messages
+ * are pending on the node. Responses wait for space in the cport queue.
+ *
+ * NOTE: This takes ownership of the message in case of success.
+ *
+ * @param cport
+ * @param msg
+ *
+ * @return 0 in case of success.
+ * @return -EBUSY if the request was refused.
+ * @return < 0 in case of error.
+ */
+int gb_dispatch_submit(uint16_t cport, struct gb_message *msg);
+
+/**
+ * Get the number of messages waiting on a cport.
+ *
+ * @param cport
+ * @param depth: number of pending messages
+ * @param peak: maximum number of pending messages since the last reset
+ *
+ * @return 0 in case of success.
+ * @return -EINVAL if cport does not exist.
+ */
+int gb_dispatch_depth_get(uint16_t cport, uint32_t *depth, uint32_t *peak);
+
+/**
+ * Reset the peak number of pending messages of all cports.
+ */
+void gb_dispatch_peak_reset(void);
+
+#endif // _GREYBUS_DISPATCH_H_
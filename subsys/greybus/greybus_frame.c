@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Framing of greybus messages on byte stream transports.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+#include "greybus_frame.h"
+
+/* Start decoding a new frame, dropping the current one */
+static void gb_frame_decoder_restart(struct gb_frame_decoder *dec, bool hunt)
+{
+	gb_message_dealloc(dec->msg);
+	dec->msg = NULL;
+	dec->hunt = hunt;
+	dec->escape = false;
+	dec->pos = 0;
+	dec->crc = GB_FRAME_CRC_INIT;
+}
+
+void gb_frame_decoder_init(struct gb_frame_decoder *dec, enum gb_frame_format format)
+{
+	*dec = (struct gb_frame_decoder){
+		.format = format,
+		.hunt = format == GB_FRAME_HDLC,
+		.crc = GB_FRAME_CRC_INIT,
+	};
+}
+
+void gb_frame_decoder_reset(struct gb_frame_decoder *dec)
+{
+	gb_message_dealloc(dec->ready);
+	dec->ready = NULL;
+	gb_frame_decoder_restart(dec, dec->format == GB_FRAME_HDLC);
+}
+
+/* Size of the current frame without flags and frame check sequence, once its header is known */
+static size_t gb_frame_len(const struct gb_frame_decoder *dec)
+{
+	return sizeof(dec->frame.cport) + sys_le16_to_cpu(dec->frame.hdr.size);
+}
+
+/*
+ * Helper called once the header is complete, which allocates the message the payload is decoded
+ * into. A frame whose message cannot be allocated is still decoded, so that the next one is found.
+ *
+ * @return false if the message size is invalid.
+ */
+static bool gb_frame_decoder_hdr_done(struct gb_frame_decoder *dec)
+{
+	const struct gb_operation_msg_hdr *hdr = &dec->frame.hdr;
+
+	if (sys_le16_to_cpu(hdr->size) < sizeof(struct gb_operation_msg_hdr)) {
+		dec->stats.framing_errors++;
+		return false;
+	}
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+	if (gb_hdr_payload_len(hdr) > CONFIG_GREYBUS_MAX_PAYLOAD_SIZE) {
+		dec->stats.dropped++;
+		return true;
+	}
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+	dec->msg = gb_message_alloc(gb_hdr_payload_len(hdr), hdr->type, hdr->operation_id,
+				    hdr->result);
+	if (!dec->msg) {
+		dec->stats.dropped++;
+	}
+
+	return true;
+}
+
+static void gb_frame_decoder_complete(struct gb_frame_decoder *dec)
+{
+	if (dec->msg) {
+		dec->ready = dec->msg;
+		dec->ready_cport = sys_le16_to_cpu(dec->frame.cport);
+		dec->msg = NULL;
+		dec->stats.frames++;
+	}
+
+	gb_frame_decoder_restart(dec, false);
+}
+
+static int gb_frame_stream_push(struct gb_frame_decoder *dec, const uint8_t *data, size_t len)
+{
+	size_t n, consumed = 0;
+
+	while (consumed < len && !dec->ready) {
+		if (dec->pos < sizeof(dec->frame)) {
+			n = MIN(len - consumed, sizeof(dec->frame) - dec->pos);
+			memcpy((uint8_t *)&dec->frame + dec->pos, data + consumed, n);
+			dec->pos += n;
+			consumed += n;
+
+			if (dec->pos < sizeof(dec->frame)) {
+				break;
+			}
+
+			/* Nothing to resynchronize on */
+			if (!gb_frame_decoder_hdr_done(dec)) {
+				return -EPROTO;
+			}
+		} else {
+			n = MIN(len - consumed, gb_frame_len(dec) - dec->pos);
+			/* Payload of a dropped frame is skipped */
+			if (dec->msg) {
+				memcpy(dec->msg->payload + dec->pos - sizeof(dec->frame),
+				       data + consumed, n);
+			}
+			dec->pos += n;
+			consumed += n;
+		}
+
+		if (dec->pos == gb_frame_len(dec)) {
+			gb_frame_decoder_complete(dec);
+		}
+	}
+
+	return consumed;
+}
+
+/* Helper called on a flag, which ends the current HDLC frame */
+static void gb_frame_hdlc_end(struct gb_frame_decoder *dec)
+{
+	/* Back to back flags, or the first flag after an error */
+	if (dec->hunt || dec->pos == 0) {
+		return gb_frame_decoder_restart(dec, false);
+	}
+
+	if (dec->escape || !dec->msg || dec->pos != gb_frame_len(dec) + sizeof(dec->fcs)) {
+		dec->stats.framing_errors++;
+		return gb_frame_decoder_restart(dec, false);
+	}
+
+	if ((uint16_t)(dec->crc ^ GB_FRAME_CRC_XOROUT) != sys_get_le16(dec->fcs)) {
+		dec->stats.crc_errors++;
+		return gb_frame_decoder_restart(dec, false);
+	}
+
+	gb_frame_decoder_complete(dec);
+}
+
+/* Helper to add an unescaped byte to the current HDLC frame */
+static void gb_frame_hdlc_byte(struct gb_frame_decoder *dec, uint8_t byte)
+{
+	if (dec->pos < sizeof(dec->frame)) {
+		((uint8_t *)&dec->frame)[dec->pos++] = byte;
+		dec->crc = crc16_ccitt(dec->crc, &byte, 1);
+
+		/* Frames without a message are dropped up to the next flag */
+		if (dec->pos == sizeof(dec->frame) &&
+		    (!gb_frame_decoder_hdr_done(dec) || !dec->msg)) {
+			gb_frame_decoder_restart(dec, true);
+		}
+	} else if (dec->pos < gb_frame_len(dec)) {
+		dec->msg->payload[dec->pos++ - sizeof(dec->frame)] = byte;
+		dec->crc = crc16_ccitt(dec->crc, &byte, 1);
+	} else if (dec->pos < gb_frame_len(dec) + sizeof(dec->fcs)) {
+		dec->fcs[dec->pos++ - gb_frame_len(dec)] = byte;
+	} else {
+		/* Longer than the header claims */
+		dec->stats.framing_errors++;
+		gb_frame_decoder_restart(dec, true);
+	}
+}
+
+/*
+ * Helper to copy a run of payload bytes which need no unescaping at once
+ *
+ * @return number of bytes consumed. 0 if the frame is not in its payload.
+ */
+static size_t gb_frame_hdlc_payload_run(struct gb_frame_decoder *dec, const uint8_t *data,
+					size_t len)
+{
+	size_t n = 0;
+
+	if (!dec->msg || dec->pos >= gb_frame_len(dec)) {
+		return 0;
+	}
+
+	len = MIN(len, gb_frame_len(dec) - dec->pos);
+	while (n < len && data[n] != GB_FRAME_FLAG && data[n] != GB_FRAME_ESCAPE) {
+		n++;
+	}
+
+	memcpy(dec->msg->payload + dec->pos - sizeof(dec->frame), data, n);
+	dec->crc = crc16_ccitt(dec->crc, data, n);
+	dec->pos += n;
+
+	return n;
+}
+
+static int gb_frame_hdlc_push(struct gb_frame_decoder *dec, const uint8_t *data, size_t len)
+{
+	size_t n, i = 0;
+	uint8_t byte;
+
+	while (i < len && !dec->ready) {
+		byte = data[i];
+
+		if (byte == GB_FRAME_FLAG) {
+			i++;
+			gb_frame_hdlc_end(dec);
+		} else if (dec->hunt) {
+			i++;
+		} else if (byte == GB_FRAME_ESCAPE) {
+			i++;
+			if (dec->escape) {
+				dec->stats.framing_errors++;
+				gb_frame_decoder_restart(dec, true);
+			} else {
+				dec->escape = true;
+			}
+		} else if (dec->escape) {
+			i++;
+			dec->escape = false;
+			gb_frame_hdlc_byte(dec, byte ^ GB_FRAME_ESCAPE_XOR);
+		} else {
+			n = gb_frame_hdlc_payload_run(dec, data + i, len - i);
+			if (n == 0) {
+				gb_frame_hdlc_byte(dec, byte);
+				n = 1;
+			}
+			i += n;
+		}
+	}
+
+	return i;
+}
+
+int gb_frame_decoder_push(struct gb_frame_decoder *dec, const uint8_t *data, size_t len)
+{
+	if (dec->format == GB_FRAME_HDLC) {
+		return gb_frame_hdlc_push(dec, data, len);
+	}
+
+	return gb_frame_stream_push(dec, data, len);
+}
+
+struct gb_message *gb_frame_decoder_pop(struct gb_frame_decoder *dec, uint16_t *cport)
+{
+	struct gb_message *msg = dec->ready;
+
+	if (msg) {
+		*cport = dec->ready_cport;
+		dec->ready = NULL;
+	}
+
+	return msg;
+}
+
+size_t gb_frame_decoder_payload_buf(struct gb_frame_decoder *dec, uint8_t **buf)
+{
+	if (dec->format != GB_FRAME_STREAM || !dec->msg || dec->pos >= gb_frame_len(dec)) {
+		return 0;
+	}
+
+	*buf = dec->msg->payload + dec->pos - sizeof(dec->frame);
+
+	return gb_frame_len(dec) - dec->pos;
+}
+
+void gb_frame_decoder_payload_commit(struct gb_frame_decoder *dec, size_t len)
+{
+	dec->pos += len;
+	if (dec->pos == gb_frame_len(dec)) {
+		gb_frame_decoder_complete(dec);
+	}
+}
+
+void gb_frame_encoder_init(struct gb_frame_encoder *enc, enum gb_frame_format format,
+			   uint16_t cport, const struct gb_message *msg)
+{
+	uint16_t crc;
+
+	enc->format = format;
+	enc->seg = 0;
+	enc->flags = 0;
+	enc->off = 0;
+	enc->msg = msg;
+	sys_put_le16(cport, enc->prefix);
+
+	if (format == GB_FRAME_HDLC) {
+		crc = crc16_ccitt(GB_FRAME_CRC_INIT, enc->prefix, sizeof(enc->prefix));
+		crc = crc16_ccitt(crc, (const uint8_t *)msg, sys_le16_to_cpu(msg->header.size));
+		sys_put_le16(crc ^ GB_FRAME_CRC_XOROUT, enc->fcs);
+	}
+}
+
+/* Get the current segment of the frame. @return length of segment */
+static size_t gb_frame_encoder_seg(const struct gb_frame_encoder *enc, const uint8_t **data)
+{
+	switch (enc->seg) {
+	case 0:
+		*data = enc->prefix;
+		return sizeof(enc->prefix);
+	case 1:
+		*data = (const uint8_t *)enc->msg;
+		return sys_le16_to_cpu(enc->msg->header.size);
+	default:
+		*data = enc->fcs;
+		return sizeof(enc->fcs);
+	}
+}
+
+/* Helper to escape as much of a segment as fits. @return number of bytes written */
+static size_t gb_frame_hdlc_escape(struct gb_frame_encoder *enc, const uint8_t *seg,
+				   size_t seg_len, uint8_t *buf, size_t len)
+{
+	size_t pos = 0;
+
+	while (enc->off < seg_len && pos < len) {
+		if (seg[enc->off] == GB_FRAME_FLAG || seg[enc->off] == GB_FRAME_ESCAPE) {
+			if (len - pos < 2) {
+				break;
+			}
+			buf[pos++] = GB_FRAME_ESCAPE;
+			buf[pos++] = seg[enc->off++] ^ GB_FRAME_ESCAPE_XOR;
+		} else {
+			buf[pos++] = seg[enc->off++];
+		}
+	}
+
+	return pos;
+}
+
+size_t gb_frame_encoder_pull(struct gb_frame_encoder *enc, uint8_t *buf, size_t len)
+{
+	size_t n, seg_len, pos = 0;
+	const uint8_t *seg;
+	const bool hdlc = enc->format == GB_FRAME_HDLC;
+	const uint8_t segs = hdlc ? 3 : 2;
+
+	if (hdlc && enc->flags == 0 && pos < len) {
+		buf[pos++] = GB_FRAME_FLAG;
+		enc->flags++;
+	}
+
+	while (enc->seg < segs && pos < len) {
+		seg_len = gb_frame_encoder_seg(enc, &seg);
+		if (hdlc) {
+			n = gb_frame_hdlc_escape(enc, seg, seg_len, buf + pos, len - pos);
+		} else {
+			n = MIN(len - pos, seg_len - enc->off);
+			memcpy(buf + pos, seg + enc->off, n);
+			enc->off += n;
+		}
+		pos += n;
+
+		if (enc->off == seg_len) {
+			enc->seg++;
+			enc->off = 0;
+		} else if (n == 0) {
+			/* No room left for an escaped byte */
+			break;
+		}
+	}
+
+	if (hdlc && enc->seg == segs && enc->flags == 1 && pos < len) {
+		buf[pos++] = GB_FRAME_FLAG;
+		enc->flags++;
+	}
+
+	return pos;
+}
+
+bool gb_frame_encoder_done(const struct gb_frame_encoder *enc)
+{
+	if (enc->format == GB_FRAME_HDLC) {
+		return enc->flags == 2;
+	}
+
+	return enc->seg == 2;
+}
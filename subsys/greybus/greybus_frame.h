@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Framing of greybus messages on byte stream transports.
+ *
+ * GB_FRAME_STREAM frames are the le16 cport followed by the greybus message, and rely on the
+ * message size for delimiting. GB_FRAME_HDLC frames add a flag on both ends, byte stuffing and a
+ * CRC-16/X.25 frame check sequence, so that a receiver can resynchronize after losing bytes.
+ */
+
+#ifndef _GREYBUS_FRAME_H_
+#define _GREYBUS_FRAME_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <greybus/greybus_messages.h>
+
+/* Frame delimiter */
+#define GB_FRAME_FLAG       0x7e
+/* Escapes the next byte, which is sent xored with GB_FRAME_ESCAPE_XOR */
+#define GB_FRAME_ESCAPE     0x7d
+#define GB_FRAME_ESCAPE_XOR 0x20
+/* Initial value and final xor of the frame check sequence */
+#define GB_FRAME_CRC_INIT   0xffff
+#define GB_FRAME_CRC_XOROUT 0xffff
+/* Largest GB_FRAME_HDLC frame of a message of _len bytes, with every byte but the flags escaped */
+#define GB_FRAME_HDLC_MAX_LEN(_len) (2 + 2 * (sizeof(__le16) + (_len) + sizeof(__le16)))
+
+enum gb_frame_format {
+	GB_FRAME_STREAM,
+	GB_FRAME_HDLC,
+};
+
+/*
+ * struct gb_frame_hdr: Start of a frame, without flag and escaping
+ *
+ * @cport: cport of the message
+ * @hdr: greybus message header
+ */
+struct gb_frame_hdr {
+	__le16 cport;
+	struct gb_operation_msg_hdr hdr;
+} __packed;
+
+/*
+ * struct gb_frame_stats: Decoder counters
+ *
+ * @frames: number of frames decoded
+ * @crc_errors: number of frames dropped for a bad frame check sequence
+ * @framing_errors: number of frames dropped for being truncated, too long, badly escaped or
+ *		    carrying an invalid message size
+ * @dropped: number of frames dropped because their message could not be allocated
+ */
+struct gb_frame_stats {
+	uint32_t frames;
+	uint32_t crc_errors;
+	uint32_t framing_errors;
+	uint32_t dropped;
+};
+
+/*
+ * struct gb_frame_decoder: Incremental frame decoder
+ *
+ * @format: framing of the input
+ * @hunt: true while bytes are discarded up to the next flag
+ * @escape: true if the last byte was GB_FRAME_ESCAPE
+ * @crc: frame check sequence of the bytes received so far
+ * @pos: number of unescaped bytes of the current frame
+ * @fcs: received frame check sequence
+ * @frame: start of the current frame
+ * @msg: message the payload is decoded into. NULL until the header is complete, or if it could
+ *	 not be allocated.
+ * @ready: complete message waiting for gb_frame_decoder_pop
+ * @ready_cport: cport of @ready
+ * @stats: counters
+ */
+struct gb_frame_decoder {
+	enum gb_frame_format format;
+	bool hunt;
+	bool escape;
+	uint16_t crc;
+	size_t pos;
+	uint8_t fcs[sizeof(__le16)];
+	struct gb_frame_hdr frame;
+	struct gb_message *msg;
+	struct gb_message *ready;
+	uint16_t ready_cport;
+	struct gb_frame_stats stats;
+};
+
+/*
+ * Initialize a decoder. HDLC decoders discard input up to the first flag.
+ *
+ * @param dec: decoder
+ * @param format: framing of the input
+ */
+void gb_frame_decoder_init(struct gb_frame_decoder *dec, enum gb_frame_format format);
+
+/*
+ * Drop the frame being decoded, and any frame waiting to be popped.
+ *
+ * @param dec: decoder
+ */
+void gb_frame_decoder_reset(struct gb_frame_decoder *dec);
+
+/*
+ * Decode bytes. Payloads are decoded straight into the message. Decoding stops after a complete
+ * frame, which must be popped before pushing the remaining bytes.
+ *
+ * Corrupt HDLC frames are dropped and counted. A stream has no delimiter to resynchronize on, so
+ * an invalid message size is reported as an error, after which the decoder must be reset together
+ * with the stream.
+ *
+ * @param dec: decoder
+ * @param data: input
+ * @param len: length of input
+ *
+ * @return number of bytes consumed.
+ * @return -EPROTO if the stream is corrupt.
+ */
+int gb_frame_decoder_push(struct gb_frame_decoder *dec, const uint8_t *data, size_t len);
+
+/*
+ * Take the decoded frame.
+ *
+ * @param dec: decoder
+ * @param cport: output cport of the message
+ *
+ * @return message. Ownership is transferred to the caller.
+ * @return NULL if no frame is complete.
+ */
+struct gb_message *gb_frame_decoder_pop(struct gb_frame_decoder *dec, uint16_t *cport);
+
+/*
+ * Get the part of the payload of the current frame which has not been received yet, so that it
+ * can be read into the message directly, e.g. by a single socket read. Only for GB_FRAME_STREAM.
+ *
+ * @param dec: decoder
+ * @param buf: output start of the missing payload
+ *
+ * @return length of the missing payload. 0 if none can be read directly.
+ */
+size_t gb_frame_decoder_payload_buf(struct gb_frame_decoder *dec, uint8_t **buf);
+
+/*
+ * Account for payload written to the buffer returned by gb_frame_decoder_payload_buf.
+ *
+ * @param dec: decoder
+ * @param len: number of bytes written
+ */
+void gb_frame_decoder_payload_commit(struct gb_frame_decoder *dec, size_t len);
+
+/*
+ * struct gb_frame_encoder: Incremental frame encoder
+ *
+ * @format: framing of the output
+ * @seg: segment being encoded. 0 is the cport, 1 the message and 2 the frame check sequence.
+ * @off: offset in the segment
+ * @flags: number of flags written
+ * @prefix: le16 cport
+ * @fcs: frame check sequence
+ * @msg: message being encoded
+ */
+struct gb_frame_encoder {
+	enum gb_frame_format format;
+	uint8_t seg;
+	uint8_t flags;
+	size_t off;
+	uint8_t prefix[sizeof(__le16)];
+	uint8_t fcs[sizeof(__le16)];
+	const struct gb_message *msg;
+};
+
+/*
+ * Start encoding a message. The message must stay valid until the encoder is done.
+ *
+ * @param enc: encoder
+ * @param format: framing of the output
+ * @param cport: cport of the message
+ * @param msg: message
+ */
+void gb_frame_encoder_init(struct gb_frame_encoder *enc, enum gb_frame_format format,
+			   uint16_t cport, const struct gb_message *msg);
+
+/*
+ * Encode as much of the frame as fits in a buffer.
+ *
+ * @param enc: encoder
+ * @param buf: output
+ * @param len: length of output. At least 2, so that escaped bytes fit.
+ *
+ * @return number of bytes written. 0 once the frame is complete.
+ */
+size_t gb_frame_encoder_pull(struct gb_frame_encoder *enc, uint8_t *buf, size_t len);
+
+/*
+ * Check if the whole frame has been pulled.
+ *
+ * @param enc: encoder
+ *
+ * @return true once the frame is complete.
+ */
+bool gb_frame_encoder_done(const struct gb_frame_encoder *enc);
+
+#endif // _GREYBUS_FRAME_H_
@@ -8,11 +8,53 @@
 
 #include "greybus_heap.h"
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(greybus_heap, CONFIG_GREYBUS_LOG_LEVEL);
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+
+/* There is no greybus heap, so gb_alloc users fail to compile */
+
+#ifdef CONFIG_GREYBUS_STATS
+void gb_heap_stats_get(struct gb_stats_heap *stats)
+{
+	*stats = (struct gb_stats_heap){0};
+}
+
+void gb_heap_stats_reset(void)
+{
+}
+#endif // CONFIG_GREYBUS_STATS
+
+#else
 
 K_HEAP_DEFINE(greybus_heap, CONFIG_GREYBUS_HEAP_MEM_POOL_SIZE);
 
+/* Number of allocations which had to wait for memory */
+static atomic_t heap_waits;
+
 void *gb_alloc(size_t len)
 {
+	void *ptr;
+	/* Interrupts cannot wait for memory to be freed */
+	const bool in_isr = k_is_in_isr();
+
+	if (!IS_ENABLED(CONFIG_GREYBUS_STATS)) {
+		return k_heap_alloc(&greybus_heap, len, in_isr ? K_NO_WAIT : K_FOREVER);
+	}
+
+	ptr = k_heap_alloc(&greybus_heap, len, K_NO_WAIT);
+	if (ptr || in_isr) {
+		return ptr;
+	}
+
+	/* Usually means CONFIG_GREYBUS_HEAP_MEM_POOL_SIZE is too small */
+	if (atomic_inc(&heap_waits) == 0) {
+		LOG_WRN("Greybus heap exhausted, waiting for %zu bytes", len);
+	}
+
 	return k_heap_alloc(&greybus_heap, len, K_FOREVER);
 }
 
@@ -20,3 +62,28 @@ void gb_free(void *ptr)
 {
 	k_heap_free(&greybus_heap, ptr);
 }
+
+#ifdef CONFIG_GREYBUS_STATS
+
+void gb_heap_stats_get(struct gb_stats_heap *stats)
+{
+	struct sys_memory_stats heap_stats;
+
+	sys_heap_runtime_stats_get(&greybus_heap.heap, &heap_stats);
+
+	stats->size = CONFIG_GREYBUS_HEAP_MEM_POOL_SIZE;
+	stats->used = heap_stats.allocated_bytes;
+	stats->peak = heap_stats.max_allocated_bytes;
+	stats->free = heap_stats.free_bytes;
+	stats->waits = atomic_get(&heap_waits);
+}
+
+void gb_heap_stats_reset(void)
+{
+	sys_heap_runtime_stats_reset_max(&greybus_heap.heap);
+	atomic_clear(&heap_waits);
+}
+
+#endif // CONFIG_GREYBUS_STATS
+
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
@@ -10,9 +10,92 @@
 #define _GREYBUS_HEAP_H_
 
 #include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/atomic.h>
+#include <greybus/greybus_stats.h>
 
+/* Bytes allocated in front of each greybus message to hold its reference count */
+#ifdef CONFIG_GREYBUS_MESSAGE_REFCOUNT
+#define GB_MESSAGE_REF_SIZE sizeof(atomic_t)
+#else
+#define GB_MESSAGE_REF_SIZE 0
+#endif // CONFIG_GREYBUS_MESSAGE_REFCOUNT
+
+#ifndef CONFIG_GREYBUS_STATIC_MEMORY
+/*
+ * Waits for memory in threads. Returns NULL when no memory is free in interrupts.
+ *
+ * Not available with CONFIG_GREYBUS_STATIC_MEMORY
+ */
 void *gb_alloc(size_t len);
 
 void gb_free(void *ptr);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+/*
+ * Get usage of the greybus heap, without allocating from it.
+ *
+ * @param stats: output
+ */
+void gb_heap_stats_get(struct gb_stats_heap *stats);
+
+/*
+ * Reset peak usage and number of waits of the greybus heap.
+ */
+void gb_heap_stats_reset(void);
+
+/*
+ * struct gb_message_pool_stats: Usage of a message size class
+ *
+ * @block_size: size of a block in bytes. 0 for heap fallback.
+ * @blocks: number of blocks in the class. 0 for heap fallback.
+ * @allocs: number of successful allocations
+ * @failures: number of allocations which found the class exhausted
+ * @used: number of blocks currently allocated
+ * @peak: maximum number of blocks allocated at the same time
+ */
+struct gb_message_pool_stats {
+	size_t block_size;
+	uint32_t blocks;
+	uint32_t allocs;
+	uint32_t failures;
+	uint32_t used;
+	uint32_t peak;
+};
+
+/*
+ * Allocate a message buffer from the smallest size class which can hold it. Falls back to the
+ * greybus heap if all suitable classes are exhausted, unless CONFIG_GREYBUS_STATIC_MEMORY is
+ * enabled.
+ *
+ * @param len: total message size including header and GB_MESSAGE_REF_SIZE
+ *
+ * @return pointer to buffer. NULL in case of error.
+ */
+void *gb_message_pool_alloc(size_t len);
+
+/*
+ * Free a buffer allocated by gb_message_pool_alloc.
+ *
+ * @param ptr: buffer. Can be NULL.
+ */
+void gb_message_pool_free(void *ptr);
+
+/*
+ * Get the number of size classes. The last class is the heap fallback, which only counts
+ * failures with CONFIG_GREYBUS_STATIC_MEMORY.
+ */
+size_t gb_message_pool_class_count(void);
+
+/*
+ * Get usage of a size class.
+ *
+ * @param idx: class index
+ * @param stats: output
+ *
+ * @return 0 in case of success.
+ * @return -EINVAL if class does not exist.
+ */
+int gb_message_pool_stats_get(size_t idx, struct gb_message_pool_stats *stats);
 
 #endif // _GREYBUS_HEAP_H_
@@ -16,6 +16,9 @@ struct gb_driver {
 	void (*disconnected)(const void *priv);
 
 	gb_operation_handler_t op_handler;
+
+	/* Maximum requests queued on a cport. 0 for CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH */
+	uint8_t queue_depth;
 };
 
 enum gb_event {
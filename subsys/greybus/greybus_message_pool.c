@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Size classed slabs for greybus messages.
+ *
+ * Most greybus messages are either empty responses or carry a small payload, while a few carry
+ * large transfers. Serving them from fixed size slabs keeps allocation constant time and avoids
+ * fragmenting the greybus heap. Messages larger than the biggest class fall back to the heap,
+ * unless the heap is disabled by CONFIG_GREYBUS_STATIC_MEMORY.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <greybus/greybus_messages.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_heap.h"
+
+#define GB_POOL_BLOCK_SIZE(payload)                                                                \
+	ROUND_UP(GB_MESSAGE_REF_SIZE + sizeof(struct gb_message) + (payload), sizeof(void *))
+
+#define GB_POOL_CLASS_DEFINE(name, payload, count)                                                 \
+	K_MEM_SLAB_DEFINE_STATIC(name, GB_POOL_BLOCK_SIZE(payload), count, sizeof(void *))
+
+GB_POOL_CLASS_DEFINE(gb_pool_hdr, 0, CONFIG_GREYBUS_MESSAGE_POOL_HDR_COUNT);
+GB_POOL_CLASS_DEFINE(gb_pool_small, CONFIG_GREYBUS_MESSAGE_POOL_SMALL_SIZE,
+		     CONFIG_GREYBUS_MESSAGE_POOL_SMALL_COUNT);
+GB_POOL_CLASS_DEFINE(gb_pool_medium, CONFIG_GREYBUS_MESSAGE_POOL_MEDIUM_SIZE,
+		     CONFIG_GREYBUS_MESSAGE_POOL_MEDIUM_COUNT);
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+/* Messages held in the transmit queues of the enabled transports, by reference or as copies */
+#ifdef CONFIG_GREYBUS_XPORT_TCPIP
+#define GB_POOL_TCPIP_QUEUED (GREYBUS_CPORT_COUNT * CONFIG_GREYBUS_TCPIP_TX_CPORT_FRAMES)
+#else
+#define GB_POOL_TCPIP_QUEUED 0
+#endif // CONFIG_GREYBUS_XPORT_TCPIP
+
+#ifdef CONFIG_GREYBUS_XPORT_SERIAL
+#define GB_POOL_SERIAL_QUEUED CONFIG_GREYBUS_SERIAL_TX_QUEUE_DEPTH
+#else
+#define GB_POOL_SERIAL_QUEUED 0
+#endif // CONFIG_GREYBUS_XPORT_SERIAL
+
+/* Unacknowledged messages stay held for retransmission */
+#ifdef CONFIG_GREYBUS_XPORT_UDP
+#define GB_POOL_UDP_QUEUED (CONFIG_GREYBUS_UDP_TX_QUEUE_DEPTH + CONFIG_GREYBUS_UDP_TX_WINDOW)
+#else
+#define GB_POOL_UDP_QUEUED 0
+#endif // CONFIG_GREYBUS_XPORT_UDP
+
+/* The dummy transport keeps the last two messages for the test to fetch */
+#ifdef CONFIG_GREYBUS_XPORT_DUMMY
+#define GB_POOL_DUMMY_QUEUED 2
+#else
+#define GB_POOL_DUMMY_QUEUED 0
+#endif // CONFIG_GREYBUS_XPORT_DUMMY
+
+/*
+ * Without a heap to fall back on, any message may end up in the large class, so it holds the worst
+ * case of the configuration and devicetree: inbound messages waiting for dispatch, a response
+ * being built by each dispatch worker, outgoing requests and their responses, a message being
+ * received on each cport, and everything the transports hold for transmission.
+ */
+#define GB_POOL_LARGE_COUNT                                                                        \
+	(CONFIG_GREYBUS_DISPATCH_MAX_PENDING + CONFIG_GREYBUS_DISPATCH_WORKERS +                   \
+	 2 * CONFIG_GREYBUS_OPERATIONS_MAX + GREYBUS_CPORT_COUNT + GB_POOL_TCPIP_QUEUED +          \
+	 GB_POOL_SERIAL_QUEUED + GB_POOL_UDP_QUEUED + GB_POOL_DUMMY_QUEUED)
+
+BUILD_ASSERT(CONFIG_GREYBUS_MAX_PAYLOAD_SIZE <= CONFIG_GREYBUS_MESSAGE_POOL_LARGE_SIZE,
+	     "Largest greybus payload does not fit in the large message class");
+#else
+#define GB_POOL_LARGE_COUNT CONFIG_GREYBUS_MESSAGE_POOL_LARGE_COUNT
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+GB_POOL_CLASS_DEFINE(gb_pool_large, CONFIG_GREYBUS_MESSAGE_POOL_LARGE_SIZE, GB_POOL_LARGE_COUNT);
+
+/*
+ * struct gb_pool_class: A message size class
+ *
+ * @slab: slab backing the class. NULL for heap fallback.
+ * @allocs: number of successful allocations
+ * @failures: number of allocations which found the class exhausted
+ * @used: number of blocks currently allocated
+ * @peak: maximum value of used
+ */
+struct gb_pool_class {
+	struct k_mem_slab *slab;
+	atomic_t allocs;
+	atomic_t failures;
+	atomic_t used;
+	atomic_t peak;
+};
+
+/* Sorted by block size. The last entry is the heap fallback. */
+static struct gb_pool_class classes[] = {
+	{.slab = &gb_pool_hdr},
+	{.slab = &gb_pool_small},
+	{.slab = &gb_pool_medium},
+	{.slab = &gb_pool_large},
+	{.slab = NULL},
+};
+
+BUILD_ASSERT(CONFIG_GREYBUS_MESSAGE_POOL_SMALL_SIZE < CONFIG_GREYBUS_MESSAGE_POOL_MEDIUM_SIZE,
+	     "Greybus message pool classes must be sorted by size");
+BUILD_ASSERT(CONFIG_GREYBUS_MESSAGE_POOL_MEDIUM_SIZE < CONFIG_GREYBUS_MESSAGE_POOL_LARGE_SIZE,
+	     "Greybus message pool classes must be sorted by size");
+
+static bool gb_pool_class_owns(const struct gb_pool_class *c, const void *ptr)
+{
+	const uint8_t *start = (const uint8_t *)c->slab->buffer;
+
+	return (const uint8_t *)ptr >= start &&
+	       (const uint8_t *)ptr < start + c->slab->info.block_size * c->slab->info.num_blocks;
+}
+
+static void gb_pool_class_account(struct gb_pool_class *c)
+{
+	atomic_val_t used = atomic_inc(&c->used) + 1;
+	atomic_val_t peak = atomic_get(&c->peak);
+
+	while (used > peak && !atomic_cas(&c->peak, peak, used)) {
+		peak = atomic_get(&c->peak);
+	}
+
+	atomic_inc(&c->allocs);
+}
+
+void *gb_message_pool_alloc(size_t len)
+{
+	size_t i;
+	void *ptr;
+	struct gb_pool_class *c;
+
+	for (i = 0; i < ARRAY_SIZE(classes) - 1; i++) {
+		c = &classes[i];
+		if (len > c->slab->info.block_size) {
+			continue;
+		}
+
+		/* Spill over to a bigger class instead of waiting */
+		if (k_mem_slab_alloc(c->slab, &ptr, K_NO_WAIT) == 0) {
+			gb_pool_class_account(c);
+			return ptr;
+		}
+
+		atomic_inc(&c->failures);
+	}
+
+	c = &classes[ARRAY_SIZE(classes) - 1];
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+	ptr = NULL;
+#else
+	ptr = gb_alloc(len);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+	if (ptr) {
+		gb_pool_class_account(c);
+	} else {
+		atomic_inc(&c->failures);
+	}
+
+	return ptr;
+}
+
+void gb_message_pool_free(void *ptr)
+{
+	size_t i;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(classes) - 1; i++) {
+		if (gb_pool_class_owns(&classes[i], ptr)) {
+			k_mem_slab_free(classes[i].slab, ptr);
+			atomic_dec(&classes[i].used);
+			return;
+		}
+	}
+
+#ifndef CONFIG_GREYBUS_STATIC_MEMORY
+	gb_free(ptr);
+	atomic_dec(&classes[ARRAY_SIZE(classes) - 1].used);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+}
+
+size_t gb_message_pool_class_count(void)
+{
+	return ARRAY_SIZE(classes);
+}
+
+int gb_message_pool_stats_get(size_t idx, struct gb_message_pool_stats *stats)
+{
+	const struct gb_pool_class *c;
+
+	if (idx >= ARRAY_SIZE(classes)) {
+		return -EINVAL;
+	}
+
+	c = &classes[idx];
+	stats->block_size = c->slab ? c->slab->info.block_size : 0;
+	stats->blocks = c->slab ? c->slab->info.num_blocks : 0;
+	stats->allocs = atomic_get(&c->allocs);
+	stats->failures = atomic_get(&c->failures);
+	stats->used = atomic_get(&c->used);
+	stats->peak = atomic_get(&c->peak);
+
+	return 0;
+}
@@ -24,17 +24,38 @@ uint16_t new_operation_id(void)
 	return temp;
 }
 
+#ifdef CONFIG_GREYBUS_MESSAGE_REFCOUNT
+/* Reference count is kept in front of the message, so the message stays contiguous on the wire */
+static atomic_t *gb_message_refs(struct gb_message *msg)
+{
+	return (atomic_t *)((uint8_t *)msg - GB_MESSAGE_REF_SIZE);
+}
+#endif // CONFIG_GREYBUS_MESSAGE_REFCOUNT
+
 struct gb_message *gb_message_alloc(size_t payload_len, uint8_t message_type, uint16_t operation_id,
 				    uint8_t status)
 {
+	uint8_t *buf;
 	struct gb_message *msg;
+	const size_t len = GB_MESSAGE_REF_SIZE + sizeof(struct gb_message) + payload_len;
 
-	msg = gb_alloc(sizeof(struct gb_message) + payload_len);
-	if (msg == NULL) {
+#ifdef CONFIG_GREYBUS_MESSAGE_POOL
+	buf = gb_message_pool_alloc(len);
+#else
+	buf = gb_alloc(len);
+#endif // CONFIG_GREYBUS_MESSAGE_POOL
+
+	if (buf == NULL) {
 		LOG_WRN("Failed to allocate Greybus request message");
 		return NULL;
 	}
 
+	msg = (struct gb_message *)(buf + GB_MESSAGE_REF_SIZE);
+
+#ifdef CONFIG_GREYBUS_MESSAGE_REFCOUNT
+	atomic_set(gb_message_refs(msg), 1);
+#endif // CONFIG_GREYBUS_MESSAGE_REFCOUNT
+
 	msg->header.size = sizeof(struct gb_operation_msg_hdr) + payload_len;
 	msg->header.operation_id = operation_id;
 	msg->header.type = message_type;
@@ -45,7 +66,37 @@ struct gb_message *gb_message_alloc(size_t payload_len, uint8_t message_type, ui
 
 void gb_message_dealloc(struct gb_message *msg)
 {
-	gb_free(msg);
+	uint8_t *buf;
+
+	if (msg == NULL) {
+		return;
+	}
+
+#ifdef CONFIG_GREYBUS_MESSAGE_REFCOUNT
+	/* atomic_dec returns the previous value */
+	if (atomic_dec(gb_message_refs(msg)) != 1) {
+		return;
+	}
+#endif // CONFIG_GREYBUS_MESSAGE_REFCOUNT
+
+	buf = (uint8_t *)msg - GB_MESSAGE_REF_SIZE;
+
+#ifdef CONFIG_GREYBUS_MESSAGE_POOL
+	gb_message_pool_free(buf);
+#else
+	gb_free(buf);
+#endif // CONFIG_GREYBUS_MESSAGE_POOL
+}
+
+struct gb_message *gb_message_get(struct gb_message *msg)
+{
+#ifdef CONFIG_GREYBUS_MESSAGE_REFCOUNT
+	atomic_inc(gb_message_refs(msg));
+
+	return msg;
+#else
+	return gb_message_copy(msg);
+#endif // CONFIG_GREYBUS_MESSAGE_REFCOUNT
 }
 
 struct gb_message *gb_message_request_alloc(size_t payload_len, uint8_t request_type,
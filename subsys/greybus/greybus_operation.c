@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tracks requests sent by this side of the link until a response arrives or they time out.
+ *
+ * In-flight operations live in a small open addressing table keyed by (cport, operation id), so
+ * matching a response is O(1). A single delayable work item expires operations whose deadline
+ * has passed.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "greybus_operation.h"
+
+LOG_MODULE_REGISTER(greybus_operation, CONFIG_GREYBUS_LOG_LEVEL);
+
+/*
+ * struct gb_operation: In-flight operation
+ *
+ * @cb: completion callback
+ * @priv: private data passed to callback
+ * @deadline: time after which the operation times out
+ * @cport: cport the request was sent on
+ * @id: operation id of the request
+ * @type: request type
+ * @used: slot is in use
+ */
+struct gb_operation {
+	gb_operation_callback_t cb;
+	void *priv;
+	k_timepoint_t deadline;
+	uint16_t cport;
+	uint16_t id;
+	uint8_t type;
+	bool used;
+};
+
+static struct gb_operation operations[CONFIG_GREYBUS_OPERATIONS_MAX];
+static struct k_spinlock operations_lock;
+/* Time at which the expiry work is scheduled to run. Only valid while the work is pending. */
+static k_timepoint_t next_deadline;
+
+static void gb_operation_timeout_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(timeout_work, gb_operation_timeout_handler);
+
+static size_t gb_operation_hash(uint16_t cport, uint16_t id)
+{
+	return (id ^ cport) % ARRAY_SIZE(operations);
+}
+
+static struct gb_operation *gb_operation_find(uint16_t cport, uint16_t id)
+{
+	size_t i, pos = gb_operation_hash(cport, id);
+	struct gb_operation *op;
+
+	for (i = 0; i < ARRAY_SIZE(operations); i++) {
+		op = &operations[(pos + i) % ARRAY_SIZE(operations)];
+		if (!op->used) {
+			return NULL;
+		}
+
+		if (op->cport == cport && op->id == id) {
+			return op;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Remove an entry while keeping every remaining entry reachable from its hash position, so that
+ * lookups can stop at the first free slot.
+ */
+static void gb_operation_remove(struct gb_operation *op)
+{
+	size_t hole = op - operations;
+	size_t i = hole, home;
+
+	operations[hole].used = false;
+
+	while (true) {
+		i = (i + 1) % ARRAY_SIZE(operations);
+		if (!operations[i].used) {
+			return;
+		}
+
+		home = gb_operation_hash(operations[i].cport, operations[i].id);
+
+		/* Entry can stay if its home lies cyclically in (hole, i] */
+		if ((hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i)) {
+			continue;
+		}
+
+		operations[hole] = operations[i];
+		operations[i].used = false;
+		hole = i;
+	}
+}
+
+/*
+ * Helper to remove one expired operation. Otherwise reschedule the timeout work for the next
+ * deadline.
+ *
+ * @return true if an operation expired.
+ */
+static bool gb_operation_expire_one(struct k_work *work, struct gb_operation *expired)
+{
+	size_t i;
+	k_spinlock_key_t key;
+	k_timepoint_t next = sys_timepoint_calc(K_FOREVER);
+
+	key = k_spin_lock(&operations_lock);
+
+	for (i = 0; i < ARRAY_SIZE(operations); i++) {
+		if (!operations[i].used) {
+			continue;
+		}
+
+		if (sys_timepoint_expired(operations[i].deadline)) {
+			*expired = operations[i];
+			gb_operation_remove(&operations[i]);
+			k_spin_unlock(&operations_lock, key);
+			return true;
+		}
+
+		if (sys_timepoint_cmp(operations[i].deadline, next) < 0) {
+			next = operations[i].deadline;
+		}
+	}
+
+	/* Rescheduled under the lock so that it cannot race with a new operation being tracked */
+	if (!K_TIMEOUT_EQ(sys_timepoint_timeout(next), K_FOREVER)) {
+		next_deadline = next;
+		k_work_reschedule(k_work_delayable_from_work(work), sys_timepoint_timeout(next));
+	}
+
+	k_spin_unlock(&operations_lock, key);
+
+	return false;
+}
+
+static void gb_operation_timeout_handler(struct k_work *work)
+{
+	struct gb_operation expired;
+
+	/* Callbacks run unlocked and may send, so only one expired entry is held at a time */
+	while (gb_operation_expire_one(work, &expired)) {
+		LOG_WRN("CPort %u, Type: %u, Id: %u timed out", expired.cport, expired.type,
+			expired.id);
+		if (expired.cb) {
+			expired.cb(expired.cport, NULL, -ETIMEDOUT, expired.priv);
+		}
+	}
+}
+
+int gb_operation_track(uint16_t cport, const struct gb_message *req, gb_operation_callback_t cb,
+		       void *priv, k_timeout_t timeout)
+{
+	size_t i, pos;
+	int ret = -ENOMEM;
+	k_spinlock_key_t key;
+	struct gb_operation *op;
+	const uint16_t id = sys_le16_to_cpu(req->header.operation_id);
+
+	if (id == 0 || gb_message_is_response(req)) {
+		return -EINVAL;
+	}
+
+	pos = gb_operation_hash(cport, id);
+
+	key = k_spin_lock(&operations_lock);
+
+	for (i = 0; i < ARRAY_SIZE(operations); i++) {
+		op = &operations[(pos + i) % ARRAY_SIZE(operations)];
+		if (!op->used) {
+			op->cb = cb;
+			op->priv = priv;
+			op->deadline = sys_timepoint_calc(timeout);
+			op->cport = cport;
+			op->id = id;
+			op->type = gb_message_type(req);
+			op->used = true;
+			ret = 0;
+
+			/* Expiry work only needs to move if this is the earliest deadline */
+			if (!K_TIMEOUT_EQ(timeout, K_FOREVER) &&
+			    (!k_work_delayable_is_pending(&timeout_work) ||
+			     sys_timepoint_cmp(op->deadline, next_deadline) < 0)) {
+				next_deadline = op->deadline;
+				k_work_reschedule(&timeout_work, timeout);
+			}
+			break;
+		}
+
+		if (op->cport == cport && op->id == id) {
+			ret = -EBUSY;
+			break;
+		}
+	}
+
+	k_spin_unlock(&operations_lock, key);
+
+	return ret;
+}
+
+bool gb_operation_cancel(uint16_t cport, uint16_t operation_id)
+{
+	struct gb_operation *op;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&operations_lock);
+
+	op = gb_operation_find(cport, operation_id);
+	if (op) {
+		gb_operation_remove(op);
+	}
+
+	k_spin_unlock(&operations_lock, key);
+
+	return op != NULL;
+}
+
+bool gb_operation_response_handle(uint16_t cport, struct gb_message *resp)
+{
+	struct gb_operation *op;
+	struct gb_operation done;
+	k_spinlock_key_t key;
+	const uint16_t id = sys_le16_to_cpu(resp->header.operation_id);
+
+	if (id == 0 || !gb_message_is_response(resp)) {
+		return false;
+	}
+
+	key = k_spin_lock(&operations_lock);
+
+	op = gb_operation_find(cport, id);
+	if (op && GB_RESPONSE(op->type) == gb_message_type(resp)) {
+		done = *op;
+		gb_operation_remove(op);
+	} else {
+		op = NULL;
+	}
+
+	k_spin_unlock(&operations_lock, key);
+
+	if (!op) {
+		return false;
+	}
+
+	if (done.cb) {
+		done.cb(cport, resp, 0, done.priv);
+	} else {
+		gb_message_dealloc(resp);
+	}
+
+	return true;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tracking of locally initiated greybus operations, and deferred completion of received ones.
+ */
+
+#ifndef _GREYBUS_OPERATION_H_
+#define _GREYBUS_OPERATION_H_
+
+#include <zephyr/kernel.h>
+#include <greybus/greybus_messages.h>
+
+#define GB_OPERATION_TIMEOUT_DEFAULT K_MSEC(CONFIG_GREYBUS_OPERATION_TIMEOUT_MS)
+
+/**
+ * Callback invoked when a tracked operation is completed.
+ *
+ * The callback takes ownership of the response message.
+ *
+ * @param cport: cport on which the request was sent.
+ * @param resp: response message. NULL if the operation did not complete successfully.
+ * @param status: 0 if a response was received, -ETIMEDOUT if the operation timed out.
+ * @param priv: private data passed when tracking the operation.
+ */
+typedef void (*gb_operation_callback_t)(uint16_t cport, struct gb_message *resp, int status,
+					void *priv);
+
+/**
+ * Start tracking a request. The request needs to be tracked before it is sent, else the
+ * response might arrive before the operation is known.
+ *
+ * @param cport
+ * @param req: request message. Unidirectional requests cannot be tracked.
+ * @param cb: completion callback. Can be NULL.
+ * @param priv: private data passed to callback.
+ * @param timeout: time to wait for a response.
+ *
+ * @return 0 in case of success.
+ * @return -EINVAL if the request cannot have a response.
+ * @return -EBUSY if an operation with the same id is already in flight on the cport.
+ * @return -ENOMEM if too many operations are in flight.
+ */
+int gb_operation_track(uint16_t cport, const struct gb_message *req, gb_operation_callback_t cb,
+		       void *priv, k_timeout_t timeout);
+
+/**
+ * Stop tracking an operation without invoking its callback.
+ *
+ * @param cport
+ * @param operation_id
+ *
+ * @return true if the operation was still in flight, else false.
+ */
+bool gb_operation_cancel(uint16_t cport, uint16_t operation_id);
+
+/**
+ * Complete the tracked operation matching a response.
+ *
+ * @param cport
+ * @param resp: response message. Ownership is transferred if the response matched.
+ *
+ * @return true if the response matched a tracked operation, else false.
+ */
+bool gb_operation_response_handle(uint16_t cport, struct gb_message *resp);
+
+/**
+ * Defer the completion of the request being handled on a cport.
+ *
+ * Can only be called from the op_handler of the driver. The handler can then return before the
+ * response is sent, for example while a bus transaction runs asynchronously. No further message
+ * is delivered to the cport until gb_operation_complete is called, so requests on a cport are
+ * still handled in order, while the worker is free to serve other cports.
+ *
+ * @param cport
+ *
+ * @return 0 in case of success.
+ * @return -EINVAL if no request is being handled on the cport, or it is already deferred.
+ */
+int gb_operation_defer(uint16_t cport);
+
+/**
+ * Complete a request deferred with gb_operation_defer, once its response has been sent.
+ *
+ * Can be called from any context, including interrupts.
+ *
+ * @param cport
+ */
+void gb_operation_complete(uint16_t cport);
+
+#endif // _GREYBUS_OPERATION_H_
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <zephyr/shell/shell.h>
+#include <greybus/greybus_stats.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_heap.h"
+#ifdef CONFIG_GREYBUS_XPORT_TCPIP
+#include "transport/tcpip.h"
+#endif // CONFIG_GREYBUS_XPORT_TCPIP
+#ifdef CONFIG_GREYBUS_XPORT_SERIAL
+#include "transport/serial.h"
+#endif // CONFIG_GREYBUS_XPORT_SERIAL
+#ifdef CONFIG_GREYBUS_XPORT_UDP
+#include "transport/udp.h"
+#endif // CONFIG_GREYBUS_XPORT_UDP
+
+/* Indexed by gb_stats_result_idx() */
+static const char *const result_names[GB_STATS_RESULT_COUNT] = {
+	"success",
+	"interrupted",
+	"timeout",
+	"no_memory",
+	"protocol_bad",
+	"overflow",
+	"invalid",
+	"retry",
+	"nonexistent",
+	"unknown_error",
+	"internal",
+};
+
+static void cport_print(const struct shell *sh, uint16_t cport, const struct gb_stats_cport *s)
+{
+	size_t i;
+
+	shell_print(sh, "%5u %8u %8u %8u %8u %10llu %10llu %5u %5u", cport, s->rx_requests,
+		    s->rx_responses, s->tx_requests, s->tx_responses,
+		    (unsigned long long)s->rx_bytes, (unsigned long long)s->tx_bytes,
+		    s->queue_depth, s->queue_peak);
+
+	if (s->rx_errors) {
+		shell_print(sh, "      error responses received: %u", s->rx_errors);
+	}
+
+	if (s->rx_refused) {
+		shell_print(sh, "      requests refused while busy: %u", s->rx_refused);
+	}
+
+	/* Index 0 is GB_OP_SUCCESS */
+	for (i = 1; i < ARRAY_SIZE(s->tx_results); i++) {
+		if (s->tx_results[i]) {
+			shell_print(sh, "      %s responses sent: %u", result_names[i],
+				    s->tx_results[i]);
+		}
+	}
+}
+
+static void heap_print(const struct shell *sh)
+{
+	struct gb_stats_heap heap;
+
+	gb_stats_heap_get(&heap);
+
+	shell_print(sh, "Heap: size %zu, used %zu, peak %zu, free %zu, waits %u", heap.size,
+		    heap.used, heap.peak, heap.free, heap.waits);
+}
+
+static void latency_print(const struct shell *sh)
+{
+	size_t i;
+	struct gb_stats_latency latency;
+
+	gb_stats_latency_get(&latency);
+
+	shell_print(sh, "Dispatch latency:");
+	shell_print(sh, "%10s %10s %10s", "below us", "queue", "handler");
+
+	for (i = 0; i < GB_STATS_LATENCY_BUCKETS - 1; i++) {
+		if (latency.queue[i] || latency.handler[i]) {
+			shell_print(sh, "%10u %10u %10u", 1U << i, latency.queue[i],
+				    latency.handler[i]);
+		}
+	}
+
+	if (latency.queue[i] || latency.handler[i]) {
+		shell_print(sh, "%10s %10u %10u", "longer", latency.queue[i], latency.handler[i]);
+	}
+}
+
+#ifdef CONFIG_GREYBUS_MESSAGE_POOL
+static void pool_print(const struct shell *sh)
+{
+	size_t i;
+	struct gb_message_pool_stats pool;
+
+	shell_print(sh, "Message pool:");
+	shell_print(sh, "%10s %6s %10s %8s %6s %6s", "block", "blocks", "allocs", "failures",
+		    "used", "peak");
+
+	for (i = 0; i < gb_message_pool_class_count(); i++) {
+		gb_message_pool_stats_get(i, &pool);
+		if (pool.block_size) {
+			shell_print(sh, "%10zu %6u %10u %8u %6u %6u", pool.block_size, pool.blocks,
+				    pool.allocs, pool.failures, pool.used, pool.peak);
+		} else {
+			shell_print(sh, "%10s %6s %10u %8u %6u %6u", "heap", "-", pool.allocs,
+				    pool.failures, pool.used, pool.peak);
+		}
+	}
+}
+#endif // CONFIG_GREYBUS_MESSAGE_POOL
+
+#ifdef CONFIG_GREYBUS_XPORT_TCPIP
+static void tcpip_print(const struct shell *sh)
+{
+	struct gb_tcpip_tx_stats tx;
+
+	gb_tcpip_tx_stats_get(&tx);
+
+	shell_print(sh, "TCP/IP transmit: %u frames in %u writes, at most %u per write", tx.frames,
+		    tx.flushes, tx.max_frames_per_flush);
+	shell_print(sh, "  early writes: control %u, full %u, deadline %u", tx.control_flushes,
+		    tx.full_flushes, tx.deadline_flushes);
+	shell_print(sh, "  blocked writes: %u, refused frames: %u", tx.blocked_writes, tx.refused);
+}
+#endif // CONFIG_GREYBUS_XPORT_TCPIP
+
+#ifdef CONFIG_GREYBUS_XPORT_SERIAL
+static void serial_print(const struct shell *sh)
+{
+	struct gb_serial_stats stats;
+
+	gb_serial_stats_get(&stats);
+
+	shell_print(sh, "Serial: %u frames received, %u transmitted", stats.rx_frames,
+		    stats.tx_frames);
+	shell_print(sh, "  receive errors: crc %u, framing %u, dropped %u, overrun bytes %u",
+		    stats.rx_crc_errors, stats.rx_framing_errors, stats.rx_dropped,
+		    stats.rx_overruns);
+}
+#endif // CONFIG_GREYBUS_XPORT_SERIAL
+
+#ifdef CONFIG_GREYBUS_XPORT_UDP
+static void udp_print(const struct shell *sh)
+{
+	struct gb_udp_stats stats;
+
+	gb_udp_stats_get(&stats);
+
+	shell_print(sh, "UDP: %u datagrams received, %u transmitted", stats.rx_datagrams,
+		    stats.tx_datagrams);
+	shell_print(sh, "  receive: duplicates %u, errors %u, dropped %u", stats.rx_duplicates,
+		    stats.rx_errors, stats.rx_dropped);
+	shell_print(sh, "  transmit: retransmits %u, timeouts %u", stats.tx_retransmits,
+		    stats.tx_timeouts);
+}
+#endif // CONFIG_GREYBUS_XPORT_UDP
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	uint16_t cport, first = 0, last = GREYBUS_CPORT_COUNT - 1;
+	struct gb_stats_cport stats;
+
+	if (argc > 1) {
+		first = last = strtoul(argv[1], NULL, 0);
+		if (first >= GREYBUS_CPORT_COUNT) {
+			shell_error(sh, "Invalid cport %s", argv[1]);
+			return -EINVAL;
+		}
+	}
+
+	shell_print(sh, "%5s %8s %8s %8s %8s %10s %10s %5s %5s", "cport", "rx req", "rx resp",
+		    "tx req", "tx resp", "rx bytes", "tx bytes", "queue", "peak");
+
+	for (cport = first; cport <= last; cport++) {
+		gb_stats_cport_get(cport, &stats);
+		cport_print(sh, cport, &stats);
+	}
+
+	if (argc > 1) {
+		return 0;
+	}
+
+	latency_print(sh);
+	heap_print(sh);
+#ifdef CONFIG_GREYBUS_MESSAGE_POOL
+	pool_print(sh);
+#endif // CONFIG_GREYBUS_MESSAGE_POOL
+#ifdef CONFIG_GREYBUS_XPORT_TCPIP
+	tcpip_print(sh);
+#endif // CONFIG_GREYBUS_XPORT_TCPIP
+#ifdef CONFIG_GREYBUS_XPORT_SERIAL
+	serial_print(sh);
+#endif // CONFIG_GREYBUS_XPORT_SERIAL
+#ifdef CONFIG_GREYBUS_XPORT_UDP
+	udp_print(sh);
+#endif // CONFIG_GREYBUS_XPORT_UDP
+
+	return 0;
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	gb_stats_reset();
+	shell_print(sh, "Greybus statistics reset");
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_greybus_stats,
+			       SHELL_CMD_ARG(reset, NULL, "Reset counters and peaks",
+					     cmd_stats_reset, 1, 0),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_greybus,
+			       SHELL_CMD_ARG(stats, &sub_greybus_stats,
+					     "Show traffic, queue and memory statistics [cport]",
+					     cmd_stats, 1, 1),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(greybus, &sub_greybus, "Greybus commands", NULL);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Per cport traffic counters and dispatch latency histograms. Counters are kept as atomics, so that
+ * they can be updated from any context without a lock. A reset clears each counter on its own, so
+ * a snapshot taken during a reset can mix old and new values.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <greybus/greybus_stats.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_dispatch.h"
+#include "greybus_heap.h"
+#include "greybus_stats_internal.h"
+
+/*
+ * struct gb_stats_counters: Counters of a cport
+ *
+ * See struct gb_stats_cport for the meaning of each counter. Byte counters wrap at 4 GiB on
+ * targets with 32-bit atomics.
+ */
+struct gb_stats_counters {
+	atomic_t rx_requests;
+	atomic_t rx_responses;
+	atomic_t rx_errors;
+	atomic_t rx_refused;
+	atomic_t tx_requests;
+	atomic_t tx_responses;
+	atomic_t tx_results[GB_STATS_RESULT_COUNT];
+	atomic_t rx_bytes;
+	atomic_t tx_bytes;
+};
+
+static struct gb_stats_counters counters[GREYBUS_CPORT_COUNT];
+
+static atomic_t queue_latency[GB_STATS_LATENCY_BUCKETS];
+static atomic_t handler_latency[GB_STATS_LATENCY_BUCKETS];
+
+static size_t gb_stats_latency_idx(uint32_t cycles)
+{
+	const uint32_t us = k_cyc_to_us_floor32(cycles);
+
+	if (us == 0) {
+		return 0;
+	}
+
+	return MIN(32 - __builtin_clz(us), GB_STATS_LATENCY_BUCKETS - 1);
+}
+
+void gb_stats_rx(uint16_t cport, const struct gb_operation_msg_hdr *hdr)
+{
+	struct gb_stats_counters *c;
+
+	if (cport >= ARRAY_SIZE(counters)) {
+		return;
+	}
+
+	c = &counters[cport];
+	atomic_add(&c->rx_bytes, sys_le16_to_cpu(hdr->size));
+
+	if (!gb_hdr_is_response(hdr)) {
+		atomic_inc(&c->rx_requests);
+		return;
+	}
+
+	atomic_inc(&c->rx_responses);
+	if (hdr->result != GB_OP_SUCCESS) {
+		atomic_inc(&c->rx_errors);
+	}
+}
+
+void gb_stats_rx_refused(uint16_t cport)
+{
+	if (cport < ARRAY_SIZE(counters)) {
+		atomic_inc(&counters[cport].rx_refused);
+	}
+}
+
+void gb_stats_tx(uint16_t cport, const struct gb_operation_msg_hdr *hdr)
+{
+	struct gb_stats_counters *c;
+
+	if (cport >= ARRAY_SIZE(counters)) {
+		return;
+	}
+
+	c = &counters[cport];
+	atomic_add(&c->tx_bytes, sys_le16_to_cpu(hdr->size));
+
+	if (!gb_hdr_is_response(hdr)) {
+		atomic_inc(&c->tx_requests);
+		return;
+	}
+
+	atomic_inc(&c->tx_responses);
+	atomic_inc(&c->tx_results[gb_stats_result_idx(hdr->result)]);
+}
+
+void gb_stats_dispatch(uint32_t queue_cycles, uint32_t handler_cycles)
+{
+	atomic_inc(&queue_latency[gb_stats_latency_idx(queue_cycles)]);
+	atomic_inc(&handler_latency[gb_stats_latency_idx(handler_cycles)]);
+}
+
+int gb_stats_cport_get(uint16_t cport, struct gb_stats_cport *stats)
+{
+	size_t i;
+	const struct gb_stats_counters *c;
+
+	if (cport >= ARRAY_SIZE(counters)) {
+		return -EINVAL;
+	}
+
+	c = &counters[cport];
+	stats->rx_requests = atomic_get(&c->rx_requests);
+	stats->rx_responses = atomic_get(&c->rx_responses);
+	stats->rx_errors = atomic_get(&c->rx_errors);
+	stats->rx_refused = atomic_get(&c->rx_refused);
+	stats->tx_requests = atomic_get(&c->tx_requests);
+	stats->tx_responses = atomic_get(&c->tx_responses);
+	for (i = 0; i < ARRAY_SIZE(stats->tx_results); i++) {
+		stats->tx_results[i] = atomic_get(&c->tx_results[i]);
+	}
+	stats->rx_bytes = (unsigned long)atomic_get(&c->rx_bytes);
+	stats->tx_bytes = (unsigned long)atomic_get(&c->tx_bytes);
+
+	return gb_dispatch_depth_get(cport, &stats->queue_depth, &stats->queue_peak);
+}
+
+void gb_stats_latency_get(struct gb_stats_latency *stats)
+{
+	size_t i;
+
+	for (i = 0; i < GB_STATS_LATENCY_BUCKETS; i++) {
+		stats->queue[i] = atomic_get(&queue_latency[i]);
+		stats->handler[i] = atomic_get(&handler_latency[i]);
+	}
+}
+
+void gb_stats_heap_get(struct gb_stats_heap *stats)
+{
+	gb_heap_stats_get(stats);
+}
+
+void gb_stats_reset(void)
+{
+	size_t i, j;
+	struct gb_stats_counters *c;
+
+	for (i = 0; i < ARRAY_SIZE(counters); i++) {
+		c = &counters[i];
+		atomic_clear(&c->rx_requests);
+		atomic_clear(&c->rx_responses);
+		atomic_clear(&c->rx_errors);
+		atomic_clear(&c->rx_refused);
+		atomic_clear(&c->tx_requests);
+		atomic_clear(&c->tx_responses);
+		for (j = 0; j < ARRAY_SIZE(c->tx_results); j++) {
+			atomic_clear(&c->tx_results[j]);
+		}
+		atomic_clear(&c->rx_bytes);
+		atomic_clear(&c->tx_bytes);
+	}
+
+	for (i = 0; i < GB_STATS_LATENCY_BUCKETS; i++) {
+		atomic_clear(&queue_latency[i]);
+		atomic_clear(&handler_latency[i]);
+	}
+
+	gb_dispatch_peak_reset();
+	gb_heap_stats_reset();
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GREYBUS_STATS_INTERNAL_H_
+#define _GREYBUS_STATS_INTERNAL_H_
+
+#include <stdint.h>
+#include <greybus/greybus_protocols.h>
+
+#ifdef CONFIG_GREYBUS_STATS
+
+/*
+ * Count a message received on a cport.
+ *
+ * @param cport
+ * @param hdr: header of the message
+ */
+void gb_stats_rx(uint16_t cport, const struct gb_operation_msg_hdr *hdr);
+
+/*
+ * Count a request refused by the dispatcher.
+ *
+ * @param cport
+ */
+void gb_stats_rx_refused(uint16_t cport);
+
+/*
+ * Count a message sent on a cport.
+ *
+ * @param cport
+ * @param hdr: header of the message
+ */
+void gb_stats_tx(uint16_t cport, const struct gb_operation_msg_hdr *hdr);
+
+/*
+ * Record the latency of a message processed by a dispatch worker.
+ *
+ * @param queue_cycles: cycles spent waiting in the cport queue
+ * @param handler_cycles: cycles spent processing the message
+ */
+void gb_stats_dispatch(uint32_t queue_cycles, uint32_t handler_cycles);
+
+#else
+
+static inline void gb_stats_rx(uint16_t cport, const struct gb_operation_msg_hdr *hdr)
+{
+}
+
+static inline void gb_stats_rx_refused(uint16_t cport)
+{
+}
+
+static inline void gb_stats_tx(uint16_t cport, const struct gb_operation_msg_hdr *hdr)
+{
+}
+
+static inline void gb_stats_dispatch(uint32_t queue_cycles, uint32_t handler_cycles)
+{
+}
+
+#endif // CONFIG_GREYBUS_STATS
+
+#endif // _GREYBUS_STATS_INTERNAL_H_
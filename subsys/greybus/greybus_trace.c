@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Records greybus messages as they move through the node, so that queueing delay can be told
+ * apart from time spent in drivers.
+ *
+ * Events are written to a ring without taking a lock. A writer claims a slot by incrementing the
+ * head, and marks the slot with its sequence number once the event is complete. Readers skip
+ * slots whose sequence number does not match, or changes while the event is copied. Events are
+ * also forwarded to the tracing subsystem as named events, if enabled.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/util.h>
+#ifdef CONFIG_GREYBUS_TRACE_TRACING
+#include <zephyr/tracing/tracing.h>
+#endif // CONFIG_GREYBUS_TRACE_TRACING
+#include "greybus_trace.h"
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_GREYBUS_TRACE_BUFFER_SIZE),
+	     "Greybus trace buffer size must be a power of two");
+
+/*
+ * struct gb_trace_slot: Entry of the trace ring
+ *
+ * @seq: one more than the position of the event in the slot. 0 while it is written.
+ * @event: recorded event
+ */
+struct gb_trace_slot {
+	atomic_t seq;
+	struct gb_trace_event event;
+};
+
+static struct gb_trace_slot ring[CONFIG_GREYBUS_TRACE_BUFFER_SIZE];
+/* Position of the next event */
+static atomic_t head;
+
+static const char *const stage_names[] = {
+	[GB_TRACE_TRANSPORT_RX] = "gb_transport_rx",
+	[GB_TRACE_RX_ENQUEUE] = "gb_rx_enqueue",
+	[GB_TRACE_WORKER_DEQUEUE] = "gb_worker_dequeue",
+	[GB_TRACE_HANDLER_ENTRY] = "gb_handler_entry",
+	[GB_TRACE_HANDLER_EXIT] = "gb_handler_exit",
+	[GB_TRACE_TX_SUBMIT] = "gb_tx_submit",
+	[GB_TRACE_TRANSPORT_TX] = "gb_transport_tx",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(stage_names) == GB_TRACE_STAGE_COUNT);
+
+void gb_trace(enum gb_trace_stage stage, uint16_t cport, const struct gb_operation_msg_hdr *hdr)
+{
+	const uint32_t pos = atomic_inc(&head);
+	struct gb_trace_slot *slot = &ring[pos & (ARRAY_SIZE(ring) - 1)];
+	const uint16_t id = sys_le16_to_cpu(hdr->operation_id);
+
+	atomic_set(&slot->seq, 0);
+
+	slot->event.cycles = k_cycle_get_32();
+	slot->event.cport = cport;
+	slot->event.operation_id = id;
+	slot->event.type = hdr->type;
+	slot->event.result = hdr->result;
+	slot->event.stage = stage;
+
+	atomic_set(&slot->seq, (uint32_t)(pos + 1));
+
+#ifdef CONFIG_GREYBUS_TRACE_TRACING
+	/* Tracing backend adds its own timestamp */
+	sys_trace_named_event(stage_names[stage], ((uint32_t)cport << 16) | id,
+			      hdr->type | (hdr->result << 8));
+#endif // CONFIG_GREYBUS_TRACE_TRACING
+}
+
+size_t gb_trace_snapshot(struct gb_trace_event *events, size_t max)
+{
+	size_t count = 0;
+	atomic_val_t seq;
+	const struct gb_trace_slot *slot;
+	const uint32_t end = atomic_get(&head);
+	/* Positions which were never written are skipped by the sequence check */
+	uint32_t pos = end - MIN(ARRAY_SIZE(ring), max);
+
+	for (; pos != end; pos++) {
+		slot = &ring[pos & (ARRAY_SIZE(ring) - 1)];
+
+		seq = atomic_get(&slot->seq);
+		if (seq == 0 || (uint32_t)seq != (uint32_t)(pos + 1)) {
+			continue;
+		}
+
+		events[count] = slot->event;
+		barrier_dmem_fence_full();
+
+		if (atomic_get(&slot->seq) == seq) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+const char *gb_trace_stage_name(enum gb_trace_stage stage)
+{
+	return stage < ARRAY_SIZE(stage_names) ? stage_names[stage] : "unknown";
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Timestamps of greybus messages at each stage of the node pipeline.
+ */
+
+#ifndef _GREYBUS_TRACE_H_
+#define _GREYBUS_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <greybus/greybus_protocols.h>
+
+/*
+ * enum gb_trace_stage: Point in the pipeline at which a message is traced
+ *
+ * @GB_TRACE_TRANSPORT_RX: message received by transport
+ * @GB_TRACE_RX_ENQUEUE: message queued for dispatch by greybus_rx_handler
+ * @GB_TRACE_WORKER_DEQUEUE: message taken by a dispatch worker
+ * @GB_TRACE_HANDLER_ENTRY: driver op_handler called
+ * @GB_TRACE_HANDLER_EXIT: driver op_handler returned
+ * @GB_TRACE_TX_SUBMIT: message handed to transport
+ * @GB_TRACE_TRANSPORT_TX: message written out by transport
+ */
+enum gb_trace_stage {
+	GB_TRACE_TRANSPORT_RX,
+	GB_TRACE_RX_ENQUEUE,
+	GB_TRACE_WORKER_DEQUEUE,
+	GB_TRACE_HANDLER_ENTRY,
+	GB_TRACE_HANDLER_EXIT,
+	GB_TRACE_TX_SUBMIT,
+	GB_TRACE_TRANSPORT_TX,
+	GB_TRACE_STAGE_COUNT,
+};
+
+/*
+ * struct gb_trace_event: A traced message
+ *
+ * @cycles: hardware cycle count at which the event was recorded
+ * @cport: cport of the message
+ * @operation_id: operation id of the message
+ * @type: message type
+ * @result: message result
+ * @stage: enum gb_trace_stage
+ */
+struct gb_trace_event {
+	uint32_t cycles;
+	uint16_t cport;
+	uint16_t operation_id;
+	uint8_t type;
+	uint8_t result;
+	uint8_t stage;
+};
+
+#ifdef CONFIG_GREYBUS_TRACE
+
+/*
+ * Record a message at a pipeline stage. Safe to call from any context, including ISRs.
+ *
+ * @param stage: pipeline stage
+ * @param cport: cport of the message
+ * @param hdr: header of the message
+ */
+void gb_trace(enum gb_trace_stage stage, uint16_t cport, const struct gb_operation_msg_hdr *hdr);
+
+/*
+ * Copy the most recent events, oldest first. Events overwritten while being copied are skipped.
+ *
+ * @param events: output
+ * @param max: maximum number of events to copy
+ *
+ * @return number of events copied
+ */
+size_t gb_trace_snapshot(struct gb_trace_event *events, size_t max);
+
+/*
+ * Get a printable name of a pipeline stage.
+ */
+const char *gb_trace_stage_name(enum gb_trace_stage stage);
+
+#else
+
+static inline void gb_trace(enum gb_trace_stage stage, uint16_t cport,
+			    const struct gb_operation_msg_hdr *hdr)
+{
+}
+
+#endif // CONFIG_GREYBUS_TRACE
+
+#endif // _GREYBUS_TRACE_H_
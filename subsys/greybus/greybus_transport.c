@@ -2,25 +2,229 @@
 /*
  * Copyright (c) 2025 Ayush Singh BeagleBoard.org
  *
- * This file contains some common functions for all greybus transports. Probably will remove this in
- * future since I don't see much point in making transports a vtable.
+ * This file contains some common functions for all greybus transports. With a single transport, its
+ * backend is called directly. With several, each cport is routed to the backend it is bound to.
  */
 
 #include "greybus_transport.h"
 #include "greybus/greybus.h"
+#include "greybus_stats_internal.h"
+#include "greybus_trace.h"
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_REGISTER(greybus_transport_common, CONFIG_GREYBUS_LOG_LEVEL);
 
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+
+#define GB_TRANSPORT_BACKEND_REF(_config, _name)                                                   \
+	COND_CODE_1(_config, (&gb_trans_backend_##_name), (NULL))
+
+const struct gb_transport_backend *const gb_transport_backends[GB_TRANSPORT_COUNT] = {
+	[GB_TRANSPORT_TCPIP] = GB_TRANSPORT_BACKEND_REF(CONFIG_GREYBUS_XPORT_TCPIP, tcpip),
+	[GB_TRANSPORT_SERIAL] = GB_TRANSPORT_BACKEND_REF(CONFIG_GREYBUS_XPORT_SERIAL, serial),
+	[GB_TRANSPORT_UDP] = GB_TRANSPORT_BACKEND_REF(CONFIG_GREYBUS_XPORT_UDP, udp),
+	[GB_TRANSPORT_DUMMY] = GB_TRANSPORT_BACKEND_REF(CONFIG_GREYBUS_XPORT_DUMMY, dummy),
+};
+
+const struct gb_transport_backend *gb_transport_bound[GREYBUS_CPORT_COUNT];
+
+/* Backends which initialized successfully, and can be bound or exited */
+static bool gb_transport_up[GB_TRANSPORT_COUNT];
+
+int gb_transport_bind(uint16_t cport, enum gb_transport_id id)
+{
+	if (cport >= GREYBUS_CPORT_COUNT || id >= GB_TRANSPORT_COUNT ||
+	    !gb_transport_backends[id] || !gb_transport_up[id]) {
+		LOG_ERR("Transport %u of CP%u is not enabled", id, cport);
+		return -ENOTSUP;
+	}
+
+	gb_transport_bound[cport] = gb_transport_backends[id];
+
+	return 0;
+}
+
+int gb_transport_init(const struct gb_transport_backend *transport)
+{
+	size_t i;
+	int ret, default_ret = 0;
+
+	/* Until connected, every cport is on the same transport as the control cport */
+	for (i = 0; i < ARRAY_SIZE(gb_transport_bound); i++) {
+		gb_transport_bound[i] = transport;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(gb_transport_backends); i++) {
+		gb_transport_up[i] = false;
+		if (!gb_transport_backends[i]) {
+			continue;
+		}
+
+		/* Other backends keep working if one of them fails, but cannot be bound to */
+		ret = gb_transport_backends[i]->init();
+		if (ret < 0) {
+			LOG_ERR("Failed to initialize transport %zu: error %d", i, ret);
+			if (gb_transport_backends[i] == transport) {
+				default_ret = ret;
+			}
+			continue;
+		}
+
+		gb_transport_up[i] = true;
+	}
+
+	/* Without the control cport transport, the AP cannot talk to us at all */
+	if (default_ret < 0) {
+		gb_transport_exit();
+		return default_ret;
+	}
+
+	return 0;
+}
+
+void gb_transport_exit(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(gb_transport_backends); i++) {
+		if (gb_transport_up[i] && gb_transport_backends[i]->exit) {
+			gb_transport_backends[i]->exit();
+		}
+		gb_transport_up[i] = false;
+	}
+}
+
+#else
+
+int gb_transport_init(const struct gb_transport_backend *transport)
+{
+	return transport->init();
+}
+
+void gb_transport_exit(void)
+{
+	if (gb_trans_backend.exit) {
+		gb_trans_backend.exit();
+	}
+}
+
+#endif // CONFIG_GREYBUS_XPORT_MULTI
+
 int gb_transport_message_send(const struct gb_message *msg, uint16_t cport)
 {
 	int retval;
-	const struct gb_transport_backend *transport_backend = gb_transport_get_backend();
+	const struct gb_transport_backend *transport_backend = gb_transport_get_backend(cport);
+
+	gb_trace(GB_TRACE_TX_SUBMIT, cport, &msg->header);
 
 	retval = transport_backend->send(cport, msg);
 	if (retval) {
 		LOG_ERR("Greybus backend failed to send: error %d", retval);
+	} else {
+		gb_stats_tx(cport, &msg->header);
+	}
+
+	return retval;
+}
+
+int gb_transport_message_send_consume(struct gb_message *msg, uint16_t cport)
+{
+	int retval;
+	const struct gb_operation_msg_hdr hdr = msg->header;
+	const struct gb_transport_backend *transport_backend = gb_transport_get_backend(cport);
+
+	if (!transport_backend->send_ref) {
+		retval = gb_transport_message_send(msg, cport);
+		gb_message_dealloc(msg);
+		return retval;
+	}
+
+	gb_trace(GB_TRACE_TX_SUBMIT, cport, &hdr);
+
+	/* Message can already be gone once this returns */
+	retval = transport_backend->send_ref(cport, msg);
+	if (retval) {
+		LOG_ERR("Greybus backend failed to send: error %d", retval);
+	} else {
+		gb_stats_tx(cport, &hdr);
 	}
 
 	return retval;
 }
+
+static void gb_transport_iov_gather(uint8_t *pos, const struct gb_iovec *iov, size_t iovcnt)
+{
+	size_t i;
+
+	for (i = 0; i < iovcnt; i++) {
+		memcpy(pos, iov[i].base, iov[i].len);
+		pos += iov[i].len;
+	}
+}
+
+int gb_transport_message_send_iov(const struct gb_iovec *iov, size_t iovcnt, uint16_t cport)
+{
+	int retval;
+	size_t i, len = 0;
+	struct gb_message *msg;
+	const struct gb_transport_backend *transport_backend = gb_transport_get_backend(cport);
+	/* Small messages, such as most fixed size responses, are framed here without allocating */
+	uint8_t frame[sizeof(struct gb_operation_msg_hdr) + CONFIG_GREYBUS_STACK_FRAME_SIZE]
+		__aligned(sizeof(void *));
+
+	if (transport_backend->send_iov) {
+		/* First fragment always starts with the header */
+		gb_trace(GB_TRACE_TX_SUBMIT, cport, iov[0].base);
+		retval = transport_backend->send_iov(cport, iov, iovcnt);
+		if (retval) {
+			LOG_ERR("Greybus backend failed to send: error %d", retval);
+		} else {
+			gb_stats_tx(cport, iov[0].base);
+		}
+		return retval;
+	}
+
+	/* Backend can only send contiguous messages */
+	for (i = 0; i < iovcnt; i++) {
+		len += iov[i].len;
+	}
+
+	if (len < sizeof(struct gb_operation_msg_hdr)) {
+		return -EINVAL;
+	}
+
+	if (len <= sizeof(frame)) {
+		gb_transport_iov_gather(frame, iov, iovcnt);
+		return gb_transport_message_send((const struct gb_message *)frame, cport);
+	}
+
+	msg = gb_message_alloc(len - sizeof(struct gb_operation_msg_hdr), 0, 0, 0);
+	if (!msg) {
+		return -ENOMEM;
+	}
+
+	gb_transport_iov_gather((uint8_t *)msg, iov, iovcnt);
+
+	return gb_transport_message_send_consume(msg, cport);
+}
+
+int gb_transport_message_request_send(const struct gb_message *req, uint16_t cport,
+				      gb_operation_callback_t cb, void *priv, k_timeout_t timeout)
+{
+	int ret;
+
+	/* Track first, since the response can arrive before send returns */
+	ret = gb_operation_track(cport, req, cb, priv, timeout);
+	if (ret < 0) {
+		LOG_ERR("Failed to track operation: error %d", ret);
+		return ret;
+	}
+
+	ret = gb_transport_message_send(req, cport);
+	if (ret < 0 && !gb_operation_cancel(cport, sys_le16_to_cpu(req->header.operation_id))) {
+		/* Operation already completed or timed out, so callback has been called */
+		return 0;
+	}
+
+	return ret;
+}
@@ -7,10 +7,89 @@
 #ifndef _GREYBUS_TRANSPORT_H_
 #define _GREYBUS_TRANSPORT_H_
 
+#include <greybus/greybus.h>
 #include <greybus/greybus_messages.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_operation.h"
+
+/*
+ * enum gb_transport_id: Transport backends which can be enabled together.
+ *
+ * Matches the order of the transport devicetree property of greybus bundles.
+ */
+enum gb_transport_id {
+	GB_TRANSPORT_TCPIP,
+	GB_TRANSPORT_SERIAL,
+	GB_TRANSPORT_UDP,
+	GB_TRANSPORT_DUMMY,
+	GB_TRANSPORT_COUNT,
+};
+
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+
+#if defined(CONFIG_GREYBUS_XPORT_DEFAULT_TCPIP)
+#define GB_TRANSPORT_DEFAULT GB_TRANSPORT_TCPIP
+#elif defined(CONFIG_GREYBUS_XPORT_DEFAULT_SERIAL)
+#define GB_TRANSPORT_DEFAULT GB_TRANSPORT_SERIAL
+#elif defined(CONFIG_GREYBUS_XPORT_DEFAULT_UDP)
+#define GB_TRANSPORT_DEFAULT GB_TRANSPORT_UDP
+#else
+#define GB_TRANSPORT_DEFAULT GB_TRANSPORT_DUMMY
+#endif
+
+/* Every enabled backend is defined under its own name, and registered by id */
+#define GB_TRANSPORT_BACKEND_DEFINE(_name)                                                         \
+	const struct gb_transport_backend gb_trans_backend_##_name
+
+extern const struct gb_transport_backend gb_trans_backend_tcpip;
+extern const struct gb_transport_backend gb_trans_backend_serial;
+extern const struct gb_transport_backend gb_trans_backend_udp;
+extern const struct gb_transport_backend gb_trans_backend_dummy;
+
+/* Backend of each id. NULL if the backend is not enabled. */
+extern const struct gb_transport_backend *const gb_transport_backends[GB_TRANSPORT_COUNT];
+
+/* Backend each cport is bound to. Written at init and when a cport is connected. */
+extern const struct gb_transport_backend *gb_transport_bound[GREYBUS_CPORT_COUNT];
+
+/**
+ * Bind a cport to a transport backend. Messages to AP on the cport are sent over this backend
+ * from now on.
+ *
+ * @param cport
+ * @param id Transport backend
+ *
+ * @return 0 in case of success.
+ * @return -ENOTSUP if the backend is not enabled.
+ */
+int gb_transport_bind(uint16_t cport, enum gb_transport_id id);
+
+#else
+
+/* Only one backend, which is called directly */
+#define GB_TRANSPORT_BACKEND_DEFINE(_name) const struct gb_transport_backend gb_trans_backend
 
 extern const struct gb_transport_backend gb_trans_backend;
 
+#endif // CONFIG_GREYBUS_XPORT_MULTI
+
+/**
+ * Initialize all transport backends.
+ *
+ * A failing backend other than the default one is only logged, and cannot be bound to.
+ *
+ * @param transport Backend of the control cport, and of cports not bound to another backend.
+ *
+ * @return 0 in case of success.
+ * @return negative error of the default backend if it failed to initialize.
+ */
+int gb_transport_init(const struct gb_transport_backend *transport);
+
+/**
+ * De-initialize all transport backends.
+ */
+void gb_transport_exit(void);
+
 /**
  * Send message to AP.
  *
@@ -23,7 +102,54 @@ extern const struct gb_transport_backend gb_trans_backend;
 int gb_transport_message_send(const struct gb_message *msg, uint16_t cport);
 
 /**
- * Helper to allocate and send success response
+ * Send message to AP, taking over the reference of the caller.
+ *
+ * The message is released once sent, even on failure. Transports which queue messages hold it
+ * instead of copying it.
+ *
+ * @param msg Message allocated with gb_message_alloc
+ * @param cport
+ *
+ * @return 0 in case of success.
+ * @return < 0 in case of error.
+ */
+int gb_transport_message_send_consume(struct gb_message *msg, uint16_t cport);
+
+/**
+ * Send message gathered from fragments to AP, without first copying it into a contiguous buffer.
+ *
+ * The fragments are only accessed during the call.
+ *
+ * @param iov Fragments of the message, starting with the greybus header.
+ * @param iovcnt Number of fragments.
+ * @param cport
+ *
+ * @return 0 in case of success.
+ * @return < 0 in case of error.
+ */
+int gb_transport_message_send_iov(const struct gb_iovec *iov, size_t iovcnt, uint16_t cport);
+
+/**
+ * Send a request to AP and track the operation until its response arrives.
+ *
+ * The callback is invoked exactly once if this function succeeds, and never otherwise.
+ *
+ * This function does not take ownership over the message.
+ *
+ * @param req Request message. Must have a non-zero operation id.
+ * @param cport
+ * @param cb Completion callback. Can be NULL, in which case the response is dropped.
+ * @param priv Private data passed to callback.
+ * @param timeout Time to wait for the response.
+ *
+ * @return 0 in case of success.
+ * @return < 0 in case of error.
+ */
+int gb_transport_message_request_send(const struct gb_message *req, uint16_t cport,
+				      gb_operation_callback_t cb, void *priv, k_timeout_t timeout);
+
+/**
+ * Helper to send success response
  *
  * NOTE: This will dealloc request message.
  *
@@ -35,16 +161,40 @@ static inline void gb_transport_message_response_success_send(struct gb_message
 							      const void *payload,
 							      size_t payload_len, uint16_t cport)
 {
-	/* Very low chance of allocation failure. However, if it happens, the only thing we can do
-	 * is either busy wait or drop the message. Choosing to drop for now. */
-	struct gb_message *resp =
-		gb_message_response_alloc_from_req(payload, payload_len, req, GB_OP_SUCCESS);
-	if (resp) {
-		gb_transport_message_send(resp, cport);
-	}
+	/* The response is gathered straight from the payload, so nothing needs to be allocated */
+	const struct gb_operation_msg_hdr hdr = {
+		.size = sys_cpu_to_le16(sizeof(struct gb_operation_msg_hdr) + payload_len),
+		.operation_id = req->header.operation_id,
+		.type = GB_RESPONSE(req->header.type),
+		.result = GB_OP_SUCCESS,
+		.pad = {0, 0},
+	};
+	const struct gb_iovec iov[] = {
+		{.base = &hdr, .len = sizeof(hdr)},
+		{.base = payload, .len = payload_len},
+	};
 
+	gb_transport_message_send_iov(iov, payload_len ? 2 : 1, cport);
+	gb_message_dealloc(req);
+}
+
+/**
+ * Helper to send a response reserved with gb_message_response_reserve, once its payload has been
+ * written in place.
+ *
+ * NOTE: This will dealloc both the request and the response.
+ *
+ * @param req Request message
+ * @param resp Reserved response
+ * @param payload_len Final payload length
+ */
+static inline void gb_transport_message_response_commit_send(struct gb_message *req,
+							     struct gb_message *resp,
+							     size_t payload_len, uint16_t cport)
+{
+	gb_message_response_commit(resp, payload_len);
+	gb_transport_message_send_consume(resp, cport);
 	gb_message_dealloc(req);
-	gb_message_dealloc(resp);
 }
 
 /**
@@ -87,11 +237,31 @@ static inline void gb_transport_message_empty_response_send(struct gb_message *r
 }
 
 /**
- * Get the current greybus transport backend
+ * Get the transport backend of the control cport
+ */
+static inline const struct gb_transport_backend *gb_transport_get_default_backend(void)
+{
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+	return gb_transport_backends[GB_TRANSPORT_DEFAULT];
+#else
+	return &gb_trans_backend;
+#endif // CONFIG_GREYBUS_XPORT_MULTI
+}
+
+/**
+ * Get the transport backend a cport is bound to
  */
-static inline const struct gb_transport_backend *gb_transport_get_backend(void)
+static inline const struct gb_transport_backend *gb_transport_get_backend(uint16_t cport)
 {
+#ifdef CONFIG_GREYBUS_XPORT_MULTI
+	/* Invalid cports are left to the default backend to reject */
+	return (cport < GREYBUS_CPORT_COUNT) ? gb_transport_bound[cport]
+					     : gb_transport_get_default_backend();
+#else
+	ARG_UNUSED(cport);
+
 	return &gb_trans_backend;
+#endif // CONFIG_GREYBUS_XPORT_MULTI
 }
 
 #endif // _GREYBUS_TRANSPORT_H_
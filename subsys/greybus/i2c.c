@@ -33,8 +33,11 @@
 #include <greybus/greybus_protocols.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/logging/log.h>
+#include <greybus-utils/manifest.h>
 #include "greybus_transport.h"
+#include "greybus_heap.h"
 #include "greybus_internal.h"
+#include "greybus_operation.h"
 
 LOG_MODULE_REGISTER(greybus_i2c, CONFIG_GREYBUS_LOG_LEVEL);
 
@@ -52,67 +55,237 @@ static void gb_i2c_protocol_functionality(uint16_t cport, struct gb_message *req
 	gb_transport_message_response_success_send(req, &resp_data, sizeof(resp_data), cport);
 }
 
+/*
+ * struct gb_i2c_transfer: Transfer request being processed on a cport
+ *
+ * @work: continues the transfer after an asynchronous operation completed
+ * @dev: i2c controller
+ * @req: transfer request
+ * @resp: response, collecting the data read
+ * @msg: i2c message of the current operation
+ * @write_data: data of the next write operation
+ * @read_data: buffer for the next read operation
+ * @cport: cport of the request
+ * @op: index of the current operation
+ * @ret: result of the last asynchronous operation
+ */
+struct gb_i2c_transfer {
+#ifdef CONFIG_I2C_CALLBACK
+	struct k_work work;
+#endif // CONFIG_I2C_CALLBACK
+	const struct device *dev;
+	struct gb_message *req;
+	struct gb_message *resp;
+	struct i2c_msg msg;
+	const uint8_t *write_data;
+	uint8_t *read_data;
+	uint16_t cport;
+	uint16_t op;
+	int ret;
+};
+
+#if defined(CONFIG_I2C_CALLBACK) && defined(CONFIG_GREYBUS_STATIC_MEMORY)
+/* A deferred transfer keeps its cport busy, so each controller has at most one in flight */
+K_MEM_SLAB_DEFINE_STATIC(gb_i2c_xfers, sizeof(struct gb_i2c_transfer),
+			 MAX(GREYBUS_BRIDGED_PHY_PROP_COUNT(i2c_controllers), 1), sizeof(void *));
+
+static struct gb_i2c_transfer *gb_i2c_transfer_alloc(void)
+{
+	void *xfer;
+
+	return k_mem_slab_alloc(&gb_i2c_xfers, &xfer, K_NO_WAIT) ? NULL : xfer;
+}
+
+static void gb_i2c_transfer_free(struct gb_i2c_transfer *xfer)
+{
+	k_mem_slab_free(&gb_i2c_xfers, xfer);
+}
+#elif defined(CONFIG_I2C_CALLBACK)
+static struct gb_i2c_transfer *gb_i2c_transfer_alloc(void)
+{
+	return gb_alloc(sizeof(struct gb_i2c_transfer));
+}
+
+static void gb_i2c_transfer_free(struct gb_i2c_transfer *xfer)
+{
+	gb_free(xfer);
+}
+#endif // CONFIG_I2C_CALLBACK
+
+static void gb_i2c_transfer_finish(struct gb_i2c_transfer *xfer, int ret)
+{
+	const uint16_t cport = xfer->cport;
+
+	if (ret < 0) {
+		LOG_ERR("Failed to transfer i2c data: %d", ret);
+		gb_message_dealloc(xfer->resp);
+		gb_transport_message_empty_response_send(xfer->req, gb_errno_to_op_result(ret),
+							 cport);
+	} else {
+		/* Data was read straight into the response */
+		gb_transport_message_response_commit_send(
+			xfer->req, xfer->resp, xfer->read_data - xfer->resp->payload, cport);
+	}
+
+#ifdef CONFIG_I2C_CALLBACK
+	gb_i2c_transfer_free(xfer);
+	gb_operation_complete(cport);
+#endif // CONFIG_I2C_CALLBACK
+}
+
+#ifdef CONFIG_I2C_CALLBACK
+static void gb_i2c_transfer_cb(const struct device *dev, int result, void *data)
+{
+	struct gb_i2c_transfer *xfer = data;
+
+	ARG_UNUSED(dev);
+
+	/* Can be called from an interrupt, so the transfer goes on in a thread */
+	xfer->ret = result;
+	k_work_submit(&xfer->work);
+}
+#endif // CONFIG_I2C_CALLBACK
+
+/*
+ * Start the current operation of a transfer.
+ *
+ * @return 0 if the operation completed.
+ * @return 1 if the operation is in progress, and gb_i2c_transfer_cb will be called.
+ * @return < 0 in case of error.
+ */
+static int gb_i2c_op_start(struct gb_i2c_transfer *xfer)
+{
+	const struct gb_i2c_transfer_request *req_data =
+		(const struct gb_i2c_transfer_request *)xfer->req->payload;
+	const struct gb_i2c_transfer_op *desc = &req_data->ops[xfer->op];
+	const uint16_t addr = sys_le16_to_cpu(desc->addr);
+	int ret;
+
+	xfer->msg.len = sys_le16_to_cpu(desc->size);
+	if (sys_le16_to_cpu(desc->flags) & GB_I2C_M_RD) {
+		xfer->msg.buf = xfer->read_data;
+		xfer->msg.flags = I2C_MSG_READ | I2C_MSG_STOP;
+	} else {
+		/* Write buffer is never modified */
+		xfer->msg.buf = (uint8_t *)xfer->write_data;
+		xfer->msg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+	}
+
+#ifdef CONFIG_I2C_CALLBACK
+	ret = i2c_transfer_cb(xfer->dev, &xfer->msg, 1, addr, gb_i2c_transfer_cb, xfer);
+	if (ret != -ENOSYS) {
+		return ret < 0 ? ret : 1;
+	}
+#endif // CONFIG_I2C_CALLBACK
+
+	/* Controller without callback support */
+	ret = i2c_transfer(xfer->dev, &xfer->msg, 1, addr);
+
+	return ret;
+}
+
+static void gb_i2c_op_done(struct gb_i2c_transfer *xfer)
+{
+	if (xfer->msg.flags & I2C_MSG_READ) {
+		xfer->read_data += xfer->msg.len;
+	} else {
+		xfer->write_data += xfer->msg.len;
+	}
+
+	xfer->op++;
+}
+
+/* Run operations until one is in progress or all are done */
+static void gb_i2c_transfer_run(struct gb_i2c_transfer *xfer)
+{
+	const struct gb_i2c_transfer_request *req_data =
+		(const struct gb_i2c_transfer_request *)xfer->req->payload;
+	const uint16_t op_count = sys_le16_to_cpu(req_data->op_count);
+	int ret;
+
+	while (xfer->op < op_count) {
+		ret = gb_i2c_op_start(xfer);
+		if (ret > 0) {
+			return;
+		}
+
+		if (ret < 0) {
+			return gb_i2c_transfer_finish(xfer, ret);
+		}
+
+		gb_i2c_op_done(xfer);
+	}
+
+	gb_i2c_transfer_finish(xfer, 0);
+}
+
+#ifdef CONFIG_I2C_CALLBACK
+static void gb_i2c_transfer_work(struct k_work *work)
+{
+	struct gb_i2c_transfer *xfer = CONTAINER_OF(work, struct gb_i2c_transfer, work);
+
+	if (xfer->ret < 0) {
+		return gb_i2c_transfer_finish(xfer, xfer->ret);
+	}
+
+	gb_i2c_op_done(xfer);
+	gb_i2c_transfer_run(xfer);
+}
+#endif // CONFIG_I2C_CALLBACK
+
 static void gb_i2c_protocol_transfer(uint16_t cport, struct gb_message *req,
 				     const struct device *dev)
 {
 	const struct gb_i2c_transfer_op *desc;
-	const uint8_t *write_data;
-	uint8_t *read_data;
 	const struct gb_i2c_transfer_request *req_data =
 		(const struct gb_i2c_transfer_request *)req->payload;
+	struct gb_i2c_transfer *xfer;
 	struct gb_message *resp;
 	size_t i, resp_size = 0;
-	uint16_t op_size, addr, op_count;
-	int ret;
+	uint16_t op_count;
+#ifndef CONFIG_I2C_CALLBACK
+	struct gb_i2c_transfer sync_xfer;
+#endif // CONFIG_I2C_CALLBACK
 
 	op_count = sys_le16_to_cpu(req_data->op_count);
-	write_data = (const uint8_t *)&req_data->ops[op_count];
 
 	for (i = 0; i < op_count; i++) {
 		desc = &req_data->ops[i];
-		if (desc->flags & GB_I2C_M_RD) {
+		if (sys_le16_to_cpu(desc->flags) & GB_I2C_M_RD) {
 			resp_size += sys_le16_to_cpu(desc->size);
 		}
 	}
 
-	resp = gb_message_alloc(resp_size, GB_RESPONSE(req->header.type), req->header.operation_id,
-				GB_OP_SUCCESS);
+	resp = gb_message_response_reserve(req, resp_size);
 	if (!resp) {
 		LOG_ERR("Failed to allocate response");
 		return gb_transport_message_empty_response_send(req, GB_OP_NO_MEMORY, cport);
 	}
-	read_data = resp->payload;
 
-	for (i = 0; i < op_count; i++) {
-		desc = &req_data->ops[i];
-		op_size = sys_le16_to_cpu(desc->size);
-		addr = sys_le16_to_cpu(desc->addr);
-
-		if (desc->flags & GB_I2C_M_RD) {
-			ret = i2c_read(dev, read_data, op_size, desc->addr);
-			if (ret < 0) {
-				LOG_ERR("Failed to read i2c data");
-				ret = gb_errno_to_op_result(ret);
-				goto free_msg;
-			}
-			read_data += op_size;
-		} else {
-			ret = i2c_write(dev, write_data, op_size, desc->addr);
-			if (ret < 0) {
-				LOG_ERR("Failed to write i2c data");
-				ret = gb_errno_to_op_result(ret);
-				goto free_msg;
-			}
-			write_data += op_size;
-		}
+#ifdef CONFIG_I2C_CALLBACK
+	/* The bus transaction completes after the handler returns */
+	xfer = gb_i2c_transfer_alloc();
+	if (!xfer) {
+		LOG_ERR("Failed to allocate transfer");
+		gb_message_dealloc(resp);
+		return gb_transport_message_empty_response_send(req, GB_OP_NO_MEMORY, cport);
 	}
 
-	gb_transport_message_send(resp, cport);
-	return gb_message_dealloc(resp);
+	k_work_init(&xfer->work, gb_i2c_transfer_work);
+	gb_operation_defer(cport);
+#else
+	xfer = &sync_xfer;
+#endif // CONFIG_I2C_CALLBACK
+
+	xfer->dev = dev;
+	xfer->req = req;
+	xfer->resp = resp;
+	xfer->write_data = (const uint8_t *)&req_data->ops[op_count];
+	xfer->read_data = resp->payload;
+	xfer->cport = cport;
+	xfer->op = 0;
 
-free_msg:
-	gb_message_dealloc(resp);
-	return gb_transport_message_empty_response_send(req, ret, cport);
+	gb_i2c_transfer_run(xfer);
 }
 
 static void gb_i2c_handler(const void *priv, struct gb_message *msg, uint16_t cport)
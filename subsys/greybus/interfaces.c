@@ -11,6 +11,10 @@
 #define INTF_START 2
 
 static struct gb_interface *intfs[AP_MAX_NODES];
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+/* Interface ids index the table, so each id owns a slot */
+static struct gb_interface intf_slots[AP_MAX_NODES];
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
 K_MUTEX_DEFINE(intfs_mutex);
 
 static int new_interface_id(void)
@@ -85,7 +89,11 @@ struct gb_interface *gb_interface_alloc(gb_controller_write_callback_t write_cb,
 		return NULL;
 	}
 
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+	intf = &intf_slots[ret];
+#else
 	intf = gb_alloc(sizeof(struct gb_interface));
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
 	if (!intf) {
 		k_mutex_unlock(&intfs_mutex);
 		return intf;
@@ -107,7 +115,9 @@ struct gb_interface *gb_interface_alloc(gb_controller_write_callback_t write_cb,
 void gb_interface_dealloc(struct gb_interface *intf)
 {
 	gb_interface_remove(intf->id);
+#ifndef CONFIG_GREYBUS_STATIC_MEMORY
 	gb_free(intf);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
 }
 
 struct gb_interface *gb_interface_get(uint8_t id)
@@ -76,6 +76,9 @@ static uint8_t bundles[] = {
 #ifdef CONFIG_GREYBUS_LOOPBACK
 	GREYBUS_CLASS_LOOPBACK,
 #endif // CONFIG_GREYBUS_LOOPBACK
+#ifdef CONFIG_GREYBUS_TELEMETRY
+	GREYBUS_CLASS_VENDOR,
+#endif // CONFIG_GREYBUS_TELEMETRY
 	DT_FOREACH_CHILD_STATUS_OKAY_SEP(_GREYBUS_BASE_NODE, _GB_BUNDLE_CB, (, ))};
 
 #define GREYBUS_MANIFEST_SIZE                                                                      \
@@ -85,6 +88,14 @@ static uint8_t bundles[] = {
 	 _GREYBUS_MANIFEST_CPORTS_SIZE(GREYBUS_CPORT_COUNT) +                                      \
 	 _GREYBUS_MANIFEST_BUNDLES_SIZE(ARRAY_SIZE(bundles)))
 
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+BUILD_ASSERT(GREYBUS_MANIFEST_SIZE <= CONFIG_GREYBUS_MAX_PAYLOAD_SIZE,
+	     "Greybus manifest does not fit in CONFIG_GREYBUS_MAX_PAYLOAD_SIZE");
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+/* Manifest is fully known after boot, so it is only built once */
+static uint8_t manifest_blob[GREYBUS_MANIFEST_SIZE] __aligned(4);
+
 size_t manifest_size(void)
 {
 	return GREYBUS_MANIFEST_SIZE;
@@ -191,6 +202,18 @@ int manifest_create(uint8_t buf[], size_t len)
 	return manifest_size();
 }
 
+int manifest_init(void)
+{
+	int ret = manifest_create(manifest_blob, sizeof(manifest_blob));
+
+	return MIN(ret, 0);
+}
+
+const uint8_t *manifest_get(void)
+{
+	return manifest_blob;
+}
+
 void manifest_print(uint8_t buf[])
 {
 	size_t i;
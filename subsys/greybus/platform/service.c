@@ -17,7 +17,7 @@ LOG_MODULE_REGISTER(greybus_service, CONFIG_GREYBUS_LOG_LEVEL);
 static int greybus_service_init(void)
 {
 	int r;
-	const struct gb_transport_backend *xport = gb_transport_get_backend();
+	const struct gb_transport_backend *xport = gb_transport_get_default_backend();
 
 	r = greybus_tls_init();
 	if (r < 0) {
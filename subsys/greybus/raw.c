@@ -74,19 +74,19 @@ int greybus_raw_register(greybus_raw_cb_t cb, void *priv)
 
 int greybus_raw_send_data(uint16_t id, uint32_t len, const uint8_t *data)
 {
-	int ret;
 	uint16_t cport_id = GREYBUS_RAW_CPORT_START + id;
 	struct gb_raw_send_request *req_data;
 	struct gb_message *msg =
 		gb_message_request_alloc(sizeof(*req_data) + len, GB_RAW_TYPE_SEND, false);
 
+	if (!msg) {
+		return -ENOMEM;
+	}
+
 	req_data = (struct gb_raw_send_request *)msg->payload;
 
 	req_data->len = sys_cpu_to_le32(len);
 	memcpy(req_data->data, data, len);
 
-	ret = gb_transport_message_send(msg, cport_id);
-	gb_message_dealloc(msg);
-
-	return ret;
+	return gb_transport_message_send_consume(msg, cport_id);
 }
@@ -31,8 +31,12 @@
 #include "greybus_transport.h"
 #include <zephyr/drivers/spi.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <greybus-utils/manifest.h>
 #include "greybus_spi.h"
+#include "greybus_heap.h"
 #include "greybus_internal.h"
+#include "greybus_operation.h"
 
 LOG_MODULE_REGISTER(greybus_spi, CONFIG_GREYBUS_LOG_LEVEL);
 
@@ -91,6 +95,258 @@ static void gb_spi_protocol_device_config(uint16_t cport, struct gb_message *req
 	gb_transport_message_response_success_send(req, &dev_data, sizeof(dev_data), cport);
 }
 
+/*
+ * struct gb_spi_xfer: Transfer request being processed on a cport
+ *
+ * @work: continues the transfer after an asynchronous transfer completed, or a delay elapsed
+ * @dev: spi controller
+ * @req: transfer request
+ * @resp: response, collecting the data read
+ * @conf: spi configuration of the current transfer
+ * @tx_buf: buffer of the current transfer to write
+ * @rx_buf: buffer of the current transfer to read
+ * @tx_set: buffer set of @tx_buf
+ * @rx_set: buffer set of @rx_buf
+ * @operation: spi operation flags from the mode of the request
+ * @trans_data: data of the next write transfer
+ * @resp_pos: offset in @resp of the next read transfer
+ * @cport: cport of the request
+ * @index: index of the current transfer
+ * @in_progress: an asynchronous transfer is in progress
+ * @ret: result of the last asynchronous transfer
+ */
+struct gb_spi_xfer {
+#ifdef CONFIG_SPI_ASYNC
+	struct k_work_delayable work;
+#endif // CONFIG_SPI_ASYNC
+	const struct device *dev;
+	struct gb_message *req;
+	struct gb_message *resp;
+	struct spi_config conf;
+	struct spi_buf tx_buf;
+	struct spi_buf rx_buf;
+	struct spi_buf_set tx_set;
+	struct spi_buf_set rx_set;
+	spi_operation_t operation;
+	const uint8_t *trans_data;
+	size_t resp_pos;
+	uint16_t cport;
+	uint16_t index;
+	bool in_progress;
+	int ret;
+};
+
+#if defined(CONFIG_SPI_ASYNC) && defined(CONFIG_GREYBUS_STATIC_MEMORY)
+/* A deferred transfer keeps its cport busy, so each controller has at most one in flight */
+K_MEM_SLAB_DEFINE_STATIC(gb_spi_xfers, sizeof(struct gb_spi_xfer),
+			 MAX(GREYBUS_BRIDGED_PHY_PROP_COUNT(spi_controllers), 1), sizeof(void *));
+
+static struct gb_spi_xfer *gb_spi_xfer_alloc(void)
+{
+	void *xfer;
+
+	return k_mem_slab_alloc(&gb_spi_xfers, &xfer, K_NO_WAIT) ? NULL : xfer;
+}
+
+static void gb_spi_xfer_free(struct gb_spi_xfer *xfer)
+{
+	k_mem_slab_free(&gb_spi_xfers, xfer);
+}
+#elif defined(CONFIG_SPI_ASYNC)
+static struct gb_spi_xfer *gb_spi_xfer_alloc(void)
+{
+	return gb_alloc(sizeof(struct gb_spi_xfer));
+}
+
+static void gb_spi_xfer_free(struct gb_spi_xfer *xfer)
+{
+	gb_free(xfer);
+}
+#endif // CONFIG_SPI_ASYNC
+
+static void gb_spi_xfer_finish(struct gb_spi_xfer *xfer, uint8_t result)
+{
+	const uint16_t cport = xfer->cport;
+
+	if (result != GB_OP_SUCCESS) {
+		gb_message_dealloc(xfer->resp);
+		gb_transport_message_empty_response_send(xfer->req, result, cport);
+	} else {
+		gb_transport_message_response_commit_send(xfer->req, xfer->resp, xfer->resp_pos,
+							  cport);
+	}
+
+#ifdef CONFIG_SPI_ASYNC
+	gb_spi_xfer_free(xfer);
+	gb_operation_complete(cport);
+#endif // CONFIG_SPI_ASYNC
+}
+
+static const struct gb_spi_transfer *gb_spi_xfer_desc(const struct gb_spi_xfer *xfer)
+{
+	const struct gb_spi_transfer_request *req_data =
+		(const struct gb_spi_transfer_request *)xfer->req->payload;
+
+	return &req_data->transfers[xfer->index];
+}
+
+#ifdef CONFIG_SPI_ASYNC
+static void gb_spi_xfer_cb(const struct device *dev, int result, void *data)
+{
+	struct gb_spi_xfer *xfer = data;
+
+	ARG_UNUSED(dev);
+
+	/* Can be called from an interrupt, so the transfer goes on in a thread */
+	xfer->ret = result;
+	k_work_reschedule(&xfer->work, K_NO_WAIT);
+}
+#endif // CONFIG_SPI_ASYNC
+
+/*
+ * Start the current transfer.
+ *
+ * @return 0 if the transfer completed.
+ * @return 1 if the transfer is in progress, and gb_spi_xfer_cb will be called.
+ * @return < 0 in case of error.
+ */
+static int gb_spi_xfer_start(struct gb_spi_xfer *xfer)
+{
+	const struct gb_spi_transfer *desc = gb_spi_xfer_desc(xfer);
+	const uint32_t len = sys_le32_to_cpu(desc->len);
+	int ret;
+
+	if (desc->cs_change) {
+		LOG_ERR("cs_change not supported");
+		return -ENOTSUP;
+	}
+
+	if (!(desc->xfer_flags & (GB_SPI_XFER_READ | GB_SPI_XFER_WRITE))) {
+		LOG_ERR("Invalid flag");
+		return -EINVAL;
+	}
+
+	xfer->conf.frequency = sys_le32_to_cpu(desc->speed_hz);
+	xfer->conf.operation = xfer->operation | SPI_WORD_SET(desc->bits_per_word);
+
+	xfer->tx_buf.buf = (void *)xfer->trans_data;
+	xfer->tx_buf.len = len;
+	xfer->rx_buf.buf = xfer->resp->payload + xfer->resp_pos;
+	xfer->rx_buf.len = len;
+
+#ifdef CONFIG_SPI_ASYNC
+	/* Set before starting, the callback can run before spi_transceive_cb returns */
+	xfer->in_progress = true;
+	ret = spi_transceive_cb(xfer->dev, &xfer->conf,
+				(desc->xfer_flags & GB_SPI_XFER_WRITE) ? &xfer->tx_set : NULL,
+				(desc->xfer_flags & GB_SPI_XFER_READ) ? &xfer->rx_set : NULL,
+				gb_spi_xfer_cb, xfer);
+	if (ret != -ENOTSUP && ret != -ENOSYS) {
+		if (ret < 0) {
+			xfer->in_progress = false;
+			LOG_ERR("SPI transfer failed: %d", ret);
+			return ret;
+		}
+
+		return 1;
+	}
+	xfer->in_progress = false;
+#endif // CONFIG_SPI_ASYNC
+
+	/* Controller without asynchronous support */
+	ret = spi_transceive(xfer->dev, &xfer->conf,
+			     (desc->xfer_flags & GB_SPI_XFER_WRITE) ? &xfer->tx_set : NULL,
+			     (desc->xfer_flags & GB_SPI_XFER_READ) ? &xfer->rx_set : NULL);
+	if (ret < 0) {
+		LOG_ERR("SPI transfer failed: %d", ret);
+	}
+
+	return ret;
+}
+
+/*
+ * Move to the next transfer.
+ *
+ * @return true if the transfer goes on from the work item once the delay elapsed.
+ */
+static bool gb_spi_xfer_done(struct gb_spi_xfer *xfer)
+{
+	const struct gb_spi_transfer *desc = gb_spi_xfer_desc(xfer);
+	const uint32_t len = sys_le32_to_cpu(desc->len);
+	const uint16_t delay = sys_le16_to_cpu(desc->delay_usecs);
+
+	if (desc->xfer_flags & GB_SPI_XFER_WRITE) {
+		xfer->trans_data += len;
+	}
+	if (desc->xfer_flags & GB_SPI_XFER_READ) {
+		xfer->resp_pos += len;
+	}
+
+	xfer->index++;
+
+	if (!delay) {
+		return false;
+	}
+
+#ifdef CONFIG_SPI_ASYNC
+	/* Do not hold the worker while waiting */
+	k_work_schedule(&xfer->work, K_USEC(delay));
+	return true;
+#else
+	k_sleep(K_USEC(delay));
+	return false;
+#endif // CONFIG_SPI_ASYNC
+}
+
+/* Run transfers until one is in progress, a delay is pending or all are done */
+static void gb_spi_xfer_run(struct gb_spi_xfer *xfer)
+{
+	const struct gb_spi_transfer_request *req_data =
+		(const struct gb_spi_transfer_request *)xfer->req->payload;
+	const uint16_t count = sys_le16_to_cpu(req_data->count);
+	int ret;
+
+	while (xfer->index < count) {
+		ret = gb_spi_xfer_start(xfer);
+		if (ret > 0) {
+			return;
+		}
+
+		if (ret < 0) {
+			return gb_spi_xfer_finish(xfer,
+						  ret == -EINVAL ? GB_OP_INVALID : GB_OP_INTERNAL);
+		}
+
+		if (gb_spi_xfer_done(xfer)) {
+			return;
+		}
+	}
+
+	gb_spi_xfer_finish(xfer, GB_OP_SUCCESS);
+}
+
+#ifdef CONFIG_SPI_ASYNC
+static void gb_spi_xfer_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct gb_spi_xfer *xfer = CONTAINER_OF(dwork, struct gb_spi_xfer, work);
+
+	if (xfer->in_progress) {
+		xfer->in_progress = false;
+		if (xfer->ret < 0) {
+			LOG_ERR("SPI transfer failed: %d", xfer->ret);
+			return gb_spi_xfer_finish(xfer, GB_OP_INTERNAL);
+		}
+
+		if (gb_spi_xfer_done(xfer)) {
+			return;
+		}
+	}
+
+	gb_spi_xfer_run(xfer);
+}
+#endif // CONFIG_SPI_ASYNC
+
 /**
  * @brief Performs a SPI transaction as one or more SPI transfers, defined
  *        in the supplied array.
@@ -98,122 +354,84 @@ static void gb_spi_protocol_device_config(uint16_t cport, struct gb_message *req
 static void gb_spi_protocol_transfer(uint16_t cport, struct gb_message *req,
 				     const struct gb_spi_driver_data *data)
 {
-	int ret;
-	struct gb_spi_transfer_request *req_data = (struct gb_spi_transfer_request *)req->payload;
-	struct gb_spi_transfer *desc;
-	struct spi_config conf = {0};
-	size_t i, resp_pos = 0, resp_size = 0;
+	const struct gb_spi_transfer_request *req_data =
+		(const struct gb_spi_transfer_request *)req->payload;
+	const struct gb_spi_transfer *desc;
+	const uint16_t count = sys_le16_to_cpu(req_data->count);
+	spi_operation_t operation = 0;
+	size_t i, resp_size = 0;
+	struct gb_spi_xfer *xfer;
 	struct gb_message *resp;
-	struct spi_buf tx_buf, rx_buf;
-	uint8_t *trans_data = req->payload + 4 + (13 * req_data->count);
-	const struct spi_buf_set tx_buf_set = {
-		.buffers = &tx_buf,
-		.count = 1,
-	};
-	const struct spi_buf_set rx_buf_set = {
-		.buffers = &rx_buf,
-		.count = 1,
-	};
+#ifndef CONFIG_SPI_ASYNC
+	struct gb_spi_xfer sync_xfer;
+#endif // CONFIG_SPI_ASYNC
 
 	if (req_data->mode & (GB_SPI_MODE_NO_CS | GB_SPI_MODE_3WIRE | GB_SPI_MODE_READY)) {
 		LOG_ERR("SPI Mode %u is not supported", req_data->mode);
 		return gb_transport_message_empty_response_send(req, GB_OP_INTERNAL, cport);
 	}
 
-	conf.slave = req_data->chip_select;
 	if (req_data->mode & GB_SPI_MODE_CPHA) {
-		conf.operation |= SPI_MODE_CPHA;
+		operation |= SPI_MODE_CPHA;
 	}
 	if (req_data->mode & GB_SPI_MODE_CPOL) {
-		conf.operation |= SPI_MODE_CPOL;
+		operation |= SPI_MODE_CPOL;
 	}
 	if (req_data->mode & GB_SPI_MODE_CS_HIGH) {
-		conf.operation |= SPI_CS_ACTIVE_HIGH;
+		operation |= SPI_CS_ACTIVE_HIGH;
 	}
 	if (req_data->mode & GB_SPI_MODE_LSB_FIRST) {
-		conf.operation |= SPI_TRANSFER_LSB;
+		operation |= SPI_TRANSFER_LSB;
 	}
 	if (req_data->mode & GB_SPI_MODE_LOOP) {
-		conf.operation |= SPI_MODE_LOOP;
+		operation |= SPI_MODE_LOOP;
 	}
 
 	/* Calculate the response size */
-	for (i = 0; i < req_data->count; ++i) {
+	for (i = 0; i < count; ++i) {
 		desc = &req_data->transfers[i];
 		if (desc->xfer_flags & GB_SPI_XFER_READ) {
-			resp_size += desc->len;
+			resp_size += sys_le32_to_cpu(desc->len);
 		}
 	}
 
-	resp = gb_message_alloc(resp_size, GB_RESPONSE(GB_SPI_TYPE_TRANSFER),
-				req->header.operation_id, GB_OP_SUCCESS);
-	for (i = 0; i < req_data->count; ++i) {
-		desc = &req_data->transfers[i];
-		conf.frequency = desc->speed_hz;
-		conf.operation |= SPI_WORD_SET(desc->bits_per_word);
+	resp = gb_message_response_reserve(req, resp_size);
+	if (!resp) {
+		LOG_ERR("Failed to allocate response");
+		return gb_transport_message_empty_response_send(req, GB_OP_NO_MEMORY, cport);
+	}
 
-		if (desc->cs_change) {
-			LOG_ERR("cs_change not supported");
-			gb_transport_message_empty_response_send(req, GB_OP_INTERNAL, cport);
-			goto free_resp;
-		}
+#ifdef CONFIG_SPI_ASYNC
+	/* The bus transaction completes after the handler returns */
+	xfer = gb_spi_xfer_alloc();
+	if (!xfer) {
+		LOG_ERR("Failed to allocate transfer");
+		gb_message_dealloc(resp);
+		return gb_transport_message_empty_response_send(req, GB_OP_NO_MEMORY, cport);
+	}
 
-		if ((desc->xfer_flags & GB_SPI_XFER_READ) &&
-		    (desc->xfer_flags & GB_SPI_XFER_WRITE)) {
-			rx_buf.buf = resp->payload + resp_pos;
-			rx_buf.len = desc->len;
-			tx_buf.buf = trans_data;
-			tx_buf.len = desc->len;
-
-			ret = spi_transceive(data->dev, &conf, &tx_buf_set, &rx_buf_set);
-			if (ret < 0) {
-				LOG_ERR("SPI transceive failed");
-				gb_transport_message_empty_response_send(req, GB_OP_INTERNAL,
-									 cport);
-				goto free_resp;
-			}
-
-			trans_data += desc->len;
-			resp_pos += desc->len;
-		} else if (desc->xfer_flags & GB_SPI_XFER_READ) {
-			rx_buf.buf = resp->payload + resp_pos;
-			rx_buf.len = desc->len;
-
-			ret = spi_read(data->dev, &conf, &rx_buf_set);
-			if (ret < 0) {
-				LOG_ERR("SPI read failed");
-				gb_transport_message_empty_response_send(req, GB_OP_INTERNAL,
-									 cport);
-				goto free_resp;
-			}
-
-			resp_pos += desc->len;
-		} else if (desc->xfer_flags & GB_SPI_XFER_WRITE) {
-			tx_buf.buf = trans_data;
-			tx_buf.len = desc->len;
-			ret = spi_write(data->dev, &conf, &tx_buf_set);
-			if (ret < 0) {
-				LOG_ERR("SPI write failed");
-				gb_transport_message_empty_response_send(req, GB_OP_INTERNAL,
-									 cport);
-				goto free_resp;
-			}
-
-			trans_data += desc->len;
-		} else {
-			LOG_ERR("Invalid flag");
-			gb_transport_message_empty_response_send(req, GB_OP_INVALID, cport);
-			goto free_resp;
-		}
+#else
+	xfer = &sync_xfer;
+#endif // CONFIG_SPI_ASYNC
 
-		k_sleep(K_USEC(desc->delay_usecs));
-	}
+	*xfer = (struct gb_spi_xfer){
+		.dev = data->dev,
+		.req = req,
+		.resp = resp,
+		.conf.slave = req_data->chip_select,
+		.tx_set = {.buffers = &xfer->tx_buf, .count = 1},
+		.rx_set = {.buffers = &xfer->rx_buf, .count = 1},
+		.operation = operation,
+		.trans_data = (const uint8_t *)&req_data->transfers[count],
+		.cport = cport,
+	};
 
-	gb_transport_message_send(resp, cport);
-	gb_message_dealloc(req);
+#ifdef CONFIG_SPI_ASYNC
+	k_work_init_delayable(&xfer->work, gb_spi_xfer_work);
+	gb_operation_defer(cport);
+#endif // CONFIG_SPI_ASYNC
 
-free_resp:
-	gb_message_dealloc(resp);
+	gb_spi_xfer_run(xfer);
 }
 
 static void gb_spi_handler(const void *priv, struct gb_message *msg, uint16_t cport)
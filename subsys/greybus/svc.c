@@ -4,6 +4,7 @@
 #include <greybus/svc.h>
 #include <greybus/apbridge.h>
 #include <zephyr/logging/log.h>
+#include "greybus_operation.h"
 
 LOG_MODULE_REGISTER(greybus_svc, CONFIG_GREYBUS_LOG_LEVEL);
 
@@ -17,61 +18,125 @@ static int gb_svc_msg_send(struct gb_message *msg)
 	return gb_apbridge_send(SVC_INF_ID, 0, msg);
 }
 
-static void svc_response_helper(struct gb_message *msg, const void *payload, size_t payload_len,
-				uint8_t status)
+/* Send a request, and call the callback once the AP responds or the operation times out. */
+static int gb_svc_request_send(struct gb_message *req, gb_operation_callback_t cb)
 {
 	int ret;
-	struct gb_message *resp = gb_message_response_alloc(payload, payload_len, msg->header.type,
-							    msg->header.operation_id, status);
+	const uint16_t id = sys_le16_to_cpu(req->header.operation_id);
+
+	ret = gb_operation_track(GB_SVC_CPORT_ID, req, cb, NULL, GB_OPERATION_TIMEOUT_DEFAULT);
+	if (ret < 0) {
+		LOG_ERR("Failed to track SVC operation %X", gb_message_type(req));
+		gb_message_dealloc(req);
+		return ret;
+	}
+
+	ret = gb_svc_msg_send(req);
+	if (ret < 0) {
+		gb_operation_cancel(GB_SVC_CPORT_ID, id);
+	}
+
+	return ret;
+}
+
+/* Reserve a response to be written in place, and sent with svc_response_send */
+static struct gb_message *svc_response_reserve(struct gb_message *msg, size_t payload_len)
+{
+	struct gb_message *resp = gb_message_response_reserve(msg, payload_len);
+
 	if (resp == NULL) {
 		LOG_ERR("Failed to allocate response for %X", msg->header.type);
-		return;
 	}
+
+	return resp;
+}
+
+static void svc_response_send(struct gb_message *resp)
+{
+	int ret;
+
 	ret = gb_svc_msg_send(resp);
 	if (ret < 0) {
 		LOG_ERR("Failed to send SVC message");
 	}
 }
 
+static void svc_response_empty(struct gb_message *msg, uint8_t status)
+{
+	struct gb_message *resp = svc_response_reserve(msg, 0);
+
+	if (resp == NULL) {
+		return;
+	}
+
+	resp->header.result = status;
+	svc_response_send(resp);
+}
+
 static void svc_intf_set_pwrm_handler(struct gb_message *msg)
 {
-	uint8_t tx_mode, rx_mode;
-	struct gb_svc_intf_set_pwrm_response resp = {.result_code = GB_SVC_SETPWRM_PWR_LOCAL};
-	struct gb_svc_intf_set_pwrm_request *req =
-		(struct gb_svc_intf_set_pwrm_request *)msg->payload;
-	tx_mode = req->tx_mode;
-	rx_mode = req->rx_mode;
-
-	if (tx_mode == GB_SVC_UNIPRO_HIBERNATE_MODE && rx_mode == GB_SVC_UNIPRO_HIBERNATE_MODE) {
-		resp.result_code = GB_SVC_SETPWRM_PWR_OK;
+	struct gb_svc_intf_set_pwrm_response *resp_data;
+	const struct gb_svc_intf_set_pwrm_request *req =
+		(const struct gb_svc_intf_set_pwrm_request *)msg->payload;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
+
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_intf_set_pwrm_response *)resp->payload;
+	resp_data->result_code = GB_SVC_SETPWRM_PWR_LOCAL;
+	if (req->tx_mode == GB_SVC_UNIPRO_HIBERNATE_MODE &&
+	    req->rx_mode == GB_SVC_UNIPRO_HIBERNATE_MODE) {
+		resp_data->result_code = GB_SVC_SETPWRM_PWR_OK;
 	}
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_intf_set_pwrm_response),
-			    GB_SVC_OP_SUCCESS);
+	svc_response_send(resp);
 }
 
 static void svc_intf_vsys_enable_disable_handler(struct gb_message *msg)
 {
-	struct gb_svc_intf_vsys_response resp = {.result_code = GB_SVC_INTF_VSYS_OK};
+	struct gb_svc_intf_vsys_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
+
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_intf_vsys_response *)resp->payload;
+	resp_data->result_code = GB_SVC_INTF_VSYS_OK;
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_intf_vsys_response),
-			    GB_SVC_OP_SUCCESS);
+	svc_response_send(resp);
 }
 
 static void svc_interface_refclk_enable_disable_handler(struct gb_message *msg)
 {
-	struct gb_svc_intf_refclk_response resp = {.result_code = GB_SVC_INTF_REFCLK_OK};
+	struct gb_svc_intf_refclk_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_intf_refclk_response),
-			    GB_SVC_OP_SUCCESS);
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_intf_refclk_response *)resp->payload;
+	resp_data->result_code = GB_SVC_INTF_REFCLK_OK;
+
+	svc_response_send(resp);
 }
 
 static void svc_interface_unipro_enable_disable_handler(struct gb_message *msg)
 {
-	struct gb_svc_intf_unipro_response resp = {.result_code = GB_SVC_INTF_UNIPRO_OK};
+	struct gb_svc_intf_unipro_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_intf_unipro_response),
-			    GB_SVC_OP_SUCCESS);
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_intf_unipro_response *)resp->payload;
+	resp_data->result_code = GB_SVC_INTF_UNIPRO_OK;
+
+	svc_response_send(resp);
 }
 
 static void svc_connection_create_handler(struct gb_message *msg)
@@ -94,11 +159,11 @@ static void svc_connection_create_handler(struct gb_message *msg)
 	LOG_DBG("Created connection between Intf %u, Cport %u and Intf %u, Cport %u", req->intf1_id,
 		req->cport1_id, req->intf2_id, req->cport2_id);
 
-	svc_response_helper(msg, NULL, 0, GB_SVC_OP_SUCCESS);
+	svc_response_empty(msg, GB_SVC_OP_SUCCESS);
 	return;
 
 fail:
-	svc_response_helper(msg, NULL, 0, GB_SVC_OP_UNKNOWN_ERROR);
+	svc_response_empty(msg, GB_SVC_OP_UNKNOWN_ERROR);
 }
 
 static void svc_connection_destroy_handler(struct gb_message *msg)
@@ -118,52 +183,89 @@ static void svc_connection_destroy_handler(struct gb_message *msg)
 		goto fail;
 	}
 
-	svc_response_helper(msg, NULL, 0, GB_SVC_OP_SUCCESS);
+	svc_response_empty(msg, GB_SVC_OP_SUCCESS);
 	return;
 
 fail:
-	svc_response_helper(msg, NULL, 0, GB_SVC_OP_UNKNOWN_ERROR);
+	svc_response_empty(msg, GB_SVC_OP_UNKNOWN_ERROR);
 }
 
 static void svc_dme_peer_get_handler(struct gb_message *msg)
 {
-	struct gb_svc_dme_peer_get_response resp = {.result_code = 0, .attr_value = 0x0126};
+	struct gb_svc_dme_peer_get_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_dme_peer_get_response),
-			    GB_SVC_OP_SUCCESS);
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_dme_peer_get_response *)resp->payload;
+	resp_data->result_code = sys_cpu_to_le16(0);
+	resp_data->attr_value = sys_cpu_to_le32(0x0126);
+
+	svc_response_send(resp);
 }
 
 static void svc_dme_peer_set_handler(struct gb_message *msg)
 {
-	struct gb_svc_dme_peer_set_response resp = {.result_code = 0};
+	struct gb_svc_dme_peer_set_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
+
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_dme_peer_set_response *)resp->payload;
+	resp_data->result_code = sys_cpu_to_le16(0);
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_dme_peer_set_response),
-			    GB_SVC_OP_SUCCESS);
+	svc_response_send(resp);
 }
 
 static void svc_pwrm_get_rail_count_handler(struct gb_message *msg)
 {
-	struct gb_svc_pwrmon_rail_count_get_response req = {.rail_count = 0};
+	struct gb_svc_pwrmon_rail_count_get_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
 
-	svc_response_helper(msg, &req, sizeof(struct gb_svc_pwrmon_rail_count_get_response),
-			    GB_SVC_OP_SUCCESS);
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_pwrmon_rail_count_get_response *)resp->payload;
+	resp_data->rail_count = 0;
+
+	svc_response_send(resp);
 }
 
 /* TODO: Some interfaces will probably want to use this */
 static void svc_interface_activate_handler(struct gb_message *msg)
 {
-	struct gb_svc_intf_activate_response resp = {.status = GB_SVC_OP_SUCCESS,
-						     .intf_type = GB_SVC_INTF_TYPE_GREYBUS};
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_intf_activate_response),
-			    GB_SVC_OP_SUCCESS);
+	struct gb_svc_intf_activate_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
+
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_intf_activate_response *)resp->payload;
+	resp_data->status = GB_SVC_OP_SUCCESS;
+	resp_data->intf_type = GB_SVC_INTF_TYPE_GREYBUS;
+
+	svc_response_send(resp);
 }
 
 static void svc_interface_resume_handler(struct gb_message *msg)
 {
-	struct gb_svc_intf_resume_response resp = {.status = GB_SVC_OP_SUCCESS};
+	struct gb_svc_intf_resume_response *resp_data;
+	struct gb_message *resp = svc_response_reserve(msg, sizeof(*resp_data));
+
+	if (resp == NULL) {
+		return;
+	}
+
+	resp_data = (struct gb_svc_intf_resume_response *)resp->payload;
+	resp_data->status = GB_SVC_OP_SUCCESS;
 
-	svc_response_helper(msg, &resp, sizeof(struct gb_svc_intf_resume_response),
-			    GB_SVC_OP_SUCCESS);
+	svc_response_send(resp);
 }
 
 static int svc_send_hello(void)
@@ -177,27 +279,49 @@ static int svc_send_hello(void)
 		return -ENOMEM;
 	}
 
-	return gb_svc_msg_send(req);
+	return gb_svc_request_send(req, NULL);
 }
 
-static void svc_version_response_handler(struct gb_message *msg)
+static void svc_version_response_handler(uint16_t cport, struct gb_message *msg, int status,
+					 void *priv)
 {
+	ARG_UNUSED(cport);
+	ARG_UNUSED(priv);
+
+	if (status < 0) {
+		LOG_ERR("SVC Version request failed: %d", status);
+		return;
+	}
+
+	gb_message_dealloc(msg);
 	svc_send_hello();
 }
 
-static void svc_module_inserted_response_handler(struct gb_message *msg)
+static void svc_module_inserted_response_handler(uint16_t cport, struct gb_message *msg,
+						 int status, void *priv)
 {
-	if (!gb_message_is_success(msg)) {
+	ARG_UNUSED(cport);
+	ARG_UNUSED(priv);
+
+	if (status < 0 || !gb_message_is_success(msg)) {
 		/* TODO: Add functionality to remove the interface in case of error */
 		LOG_ERR("Module Inserted Event failed");
 	}
+
+	gb_message_dealloc(msg);
 }
 
-static void svc_module_removed_response_handler(struct gb_message *msg)
+static void svc_module_removed_response_handler(uint16_t cport, struct gb_message *msg,
+						int status, void *priv)
 {
-	if (!gb_message_is_success(msg)) {
+	ARG_UNUSED(cport);
+	ARG_UNUSED(priv);
+
+	if (status < 0 || !gb_message_is_success(msg)) {
 		LOG_DBG("Module Removal Failed");
 	}
+
+	gb_message_dealloc(msg);
 }
 
 static void gb_handle_msg(struct gb_message *msg)
@@ -207,7 +331,7 @@ static void gb_handle_msg(struct gb_message *msg)
 	case GB_SVC_TYPE_ROUTE_CREATE:
 	case GB_SVC_TYPE_ROUTE_DESTROY:
 	case GB_SVC_TYPE_PING:
-		svc_response_helper(msg, NULL, 0, GB_OP_SUCCESS);
+		svc_response_empty(msg, GB_OP_SUCCESS);
 		break;
 	case GB_SVC_TYPE_CONN_CREATE:
 		svc_connection_create_handler(msg);
@@ -245,17 +369,6 @@ static void gb_handle_msg(struct gb_message *msg)
 	case GB_SVC_TYPE_INTF_RESUME:
 		svc_interface_resume_handler(msg);
 		break;
-	case GB_RESPONSE(GB_SVC_TYPE_PROTOCOL_VERSION):
-		svc_version_response_handler(msg);
-		break;
-	case GB_RESPONSE(GB_SVC_TYPE_SVC_HELLO):
-		break;
-	case GB_RESPONSE(GB_SVC_TYPE_MODULE_INSERTED):
-		svc_module_inserted_response_handler(msg);
-		break;
-	case GB_RESPONSE(GB_SVC_TYPE_MODULE_REMOVED):
-		svc_module_removed_response_handler(msg);
-		break;
 	default:
 		LOG_WRN("Handling SVC operation Type %X not supported yet", msg->header.type);
 	}
@@ -264,7 +377,11 @@ static void gb_handle_msg(struct gb_message *msg)
 static int gb_svc_intf_write(struct gb_interface *intf, struct gb_message *msg, uint16_t cport)
 {
 	ARG_UNUSED(intf);
-	ARG_UNUSED(cport);
+
+	/* Responses to requests sent by SVC */
+	if (gb_operation_response_handle(cport, msg)) {
+		return 0;
+	}
 
 	gb_handle_msg(msg);
 	gb_message_dealloc(msg);
@@ -303,7 +420,7 @@ int gb_svc_send_version(void)
 		return -ENOMEM;
 	}
 
-	return gb_svc_msg_send(req);
+	return gb_svc_request_send(req, svc_version_response_handler);
 }
 
 int gb_svc_send_module_inserted(uint8_t primary_intf_id, uint8_t intf_count, uint16_t flags)
@@ -321,7 +438,7 @@ int gb_svc_send_module_inserted(uint8_t primary_intf_id, uint8_t intf_count, uin
 		return -ENOMEM;
 	}
 
-	return gb_svc_msg_send(req);
+	return gb_svc_request_send(req, svc_module_inserted_response_handler);
 }
 
 int gb_svc_send_module_removed(uint8_t primary_intf_id)
@@ -335,5 +452,5 @@ int gb_svc_send_module_removed(uint8_t primary_intf_id)
 		return -ENOMEM;
 	}
 
-	return gb_svc_msg_send(req);
+	return gb_svc_request_send(req, svc_module_removed_response_handler);
 }
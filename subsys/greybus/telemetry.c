@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Vendor protocol letting the AP poll the health of the node: dispatch latency, per cport
+ * counters, memory usage and thread cpu usage, as compact little endian snapshots.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <greybus/greybus_protocols.h>
+#include <greybus/greybus_stats.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_heap.h"
+#include "greybus_internal.h"
+#include "greybus_transport.h"
+
+LOG_MODULE_REGISTER(greybus_telemetry, CONFIG_GREYBUS_LOG_LEVEL);
+
+BUILD_ASSERT(GB_TELEMETRY_LATENCY_BUCKETS == GB_STATS_LATENCY_BUCKETS);
+
+#define GB_TELEMETRY_CPORTS_MAX 16
+#define GB_TELEMETRY_POOLS_MAX  8
+
+/*
+ * Responses are built in a static buffer rather than allocated, so that reading the heap usage
+ * does not change it. The cport is only ever served by one worker at a time.
+ */
+static union {
+	struct {
+		struct gb_telemetry_summary_response hdr;
+		struct gb_telemetry_pool pools[GB_TELEMETRY_POOLS_MAX];
+	} __packed summary;
+	struct {
+		struct gb_telemetry_cports_response hdr;
+		struct gb_telemetry_cport cports[GB_TELEMETRY_CPORTS_MAX];
+	} __packed cports;
+	struct {
+		struct gb_telemetry_threads_response hdr;
+		struct gb_telemetry_thread threads[CONFIG_GREYBUS_TELEMETRY_THREADS_MAX];
+	} __packed threads;
+} resp;
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+BUILD_ASSERT(sizeof(resp.summary) <= CONFIG_GREYBUS_MAX_PAYLOAD_SIZE,
+	     "Telemetry summary response does not fit in CONFIG_GREYBUS_MAX_PAYLOAD_SIZE");
+BUILD_ASSERT(sizeof(resp.cports) <= CONFIG_GREYBUS_MAX_PAYLOAD_SIZE,
+	     "Telemetry cports response does not fit in CONFIG_GREYBUS_MAX_PAYLOAD_SIZE");
+BUILD_ASSERT(sizeof(resp.threads) <= CONFIG_GREYBUS_MAX_PAYLOAD_SIZE,
+	     "Telemetry threads response does not fit in CONFIG_GREYBUS_MAX_PAYLOAD_SIZE");
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+static size_t gb_telemetry_pools_fill(struct gb_telemetry_pool *pools)
+{
+	size_t count = 0;
+#ifdef CONFIG_GREYBUS_MESSAGE_POOL
+	struct gb_message_pool_stats pool;
+
+	for (; count < MIN(gb_message_pool_class_count(), GB_TELEMETRY_POOLS_MAX); count++) {
+		gb_message_pool_stats_get(count, &pool);
+		pools[count].block_size = sys_cpu_to_le32(pool.block_size);
+		pools[count].blocks = sys_cpu_to_le32(pool.blocks);
+		pools[count].used = sys_cpu_to_le32(pool.used);
+		pools[count].peak = sys_cpu_to_le32(pool.peak);
+		pools[count].failures = sys_cpu_to_le32(pool.failures);
+	}
+#endif // CONFIG_GREYBUS_MESSAGE_POOL
+
+	return count;
+}
+
+static void gb_telemetry_summary(struct gb_message *req, uint16_t cport)
+{
+	size_t i, pools;
+	struct gb_stats_heap heap;
+	struct gb_stats_latency latency;
+	struct gb_telemetry_summary_response *r = &resp.summary.hdr;
+
+	gb_stats_heap_get(&heap);
+	gb_stats_latency_get(&latency);
+	pools = gb_telemetry_pools_fill(resp.summary.pools);
+
+	r->version = GB_TELEMETRY_VERSION;
+	r->latency_buckets = GB_TELEMETRY_LATENCY_BUCKETS;
+	r->cport_count = sys_cpu_to_le16(GREYBUS_CPORT_COUNT);
+	r->pool_count = pools;
+	memset(r->pad, 0, sizeof(r->pad));
+	r->uptime_ms = sys_cpu_to_le32(k_uptime_get_32());
+	r->heap_size = sys_cpu_to_le32(heap.size);
+	r->heap_used = sys_cpu_to_le32(heap.used);
+	r->heap_peak = sys_cpu_to_le32(heap.peak);
+	r->heap_free = sys_cpu_to_le32(heap.free);
+	r->heap_waits = sys_cpu_to_le32(heap.waits);
+
+	for (i = 0; i < GB_TELEMETRY_LATENCY_BUCKETS; i++) {
+		r->queue_latency[i] = sys_cpu_to_le32(latency.queue[i]);
+		r->handler_latency[i] = sys_cpu_to_le32(latency.handler[i]);
+	}
+
+	gb_transport_message_response_success_send(
+		req, r, sizeof(*r) + pools * sizeof(struct gb_telemetry_pool), cport);
+}
+
+static void gb_telemetry_cport_fill(struct gb_telemetry_cport *out, const struct gb_stats_cport *s)
+{
+	size_t i;
+	uint32_t errors = 0;
+
+	/* Index 0 is GB_OP_SUCCESS */
+	for (i = 1; i < ARRAY_SIZE(s->tx_results); i++) {
+		errors += s->tx_results[i];
+	}
+
+	out->rx_requests = sys_cpu_to_le32(s->rx_requests);
+	out->rx_responses = sys_cpu_to_le32(s->rx_responses);
+	out->rx_errors = sys_cpu_to_le32(s->rx_errors);
+	out->tx_requests = sys_cpu_to_le32(s->tx_requests);
+	out->tx_responses = sys_cpu_to_le32(s->tx_responses);
+	out->tx_errors = sys_cpu_to_le32(errors);
+	out->rx_bytes = sys_cpu_to_le64(s->rx_bytes);
+	out->tx_bytes = sys_cpu_to_le64(s->tx_bytes);
+	out->queue_depth = sys_cpu_to_le16(s->queue_depth);
+	out->queue_peak = sys_cpu_to_le16(s->queue_peak);
+}
+
+static void gb_telemetry_cports(struct gb_message *req, uint16_t cport)
+{
+	size_t i;
+	uint16_t first, count;
+	struct gb_stats_cport stats;
+	const struct gb_telemetry_cports_request *r_req =
+		(const struct gb_telemetry_cports_request *)req->payload;
+
+	if (gb_message_payload_len(req) < sizeof(*r_req)) {
+		LOG_ERR("Short cports request");
+		return gb_transport_message_empty_response_send(req, GB_OP_INVALID, cport);
+	}
+
+	first = sys_le16_to_cpu(r_req->first);
+	if (first >= GREYBUS_CPORT_COUNT) {
+		return gb_transport_message_empty_response_send(req, GB_OP_INVALID, cport);
+	}
+
+	count = MIN(sys_le16_to_cpu(r_req->count), GREYBUS_CPORT_COUNT - first);
+	count = MIN(count, GB_TELEMETRY_CPORTS_MAX);
+
+	for (i = 0; i < count; i++) {
+		gb_stats_cport_get(first + i, &stats);
+		gb_telemetry_cport_fill(&resp.cports.cports[i], &stats);
+	}
+
+	resp.cports.hdr.first = sys_cpu_to_le16(first);
+	resp.cports.hdr.count = sys_cpu_to_le16(count);
+
+	gb_transport_message_response_success_send(
+		req, &resp.cports,
+		sizeof(resp.cports.hdr) + count * sizeof(struct gb_telemetry_cport), cport);
+}
+
+static void gb_telemetry_thread_cb(const struct k_thread *thread, void *user_data)
+{
+	size_t *count = user_data;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	struct gb_telemetry_thread *out;
+	k_thread_runtime_stats_t stats;
+
+	if (*count >= ARRAY_SIZE(resp.threads.threads) ||
+	    k_thread_runtime_stats_get((k_tid_t)thread, &stats) < 0) {
+		return;
+	}
+
+	out = &resp.threads.threads[*count];
+
+	out->cycles = sys_cpu_to_le64(stats.execution_cycles);
+	memset(out->name, 0, sizeof(out->name));
+	if (name) {
+		strncpy(out->name, name, sizeof(out->name));
+	}
+
+	(*count)++;
+}
+
+static void gb_telemetry_threads(struct gb_message *req, uint16_t cport)
+{
+	size_t count = 0;
+	k_thread_runtime_stats_t all;
+	struct gb_telemetry_threads_response *r = &resp.threads.hdr;
+
+	k_thread_foreach(gb_telemetry_thread_cb, &count);
+	k_thread_runtime_stats_all_get(&all);
+
+	r->cycles_per_sec = sys_cpu_to_le32(sys_clock_hw_cycles_per_sec());
+	r->count = sys_cpu_to_le16(count);
+	r->pad = 0;
+	r->busy_cycles = sys_cpu_to_le64(all.total_cycles);
+	r->total_cycles = sys_cpu_to_le64(all.execution_cycles);
+
+	gb_transport_message_response_success_send(
+		req, r, sizeof(*r) + count * sizeof(struct gb_telemetry_thread), cport);
+}
+
+static void gb_telemetry_handler(const void *priv, struct gb_message *msg, uint16_t cport)
+{
+	ARG_UNUSED(priv);
+
+	switch (gb_message_type(msg)) {
+	case GB_TELEMETRY_TYPE_SUMMARY:
+		return gb_telemetry_summary(msg, cport);
+	case GB_TELEMETRY_TYPE_CPORTS:
+		return gb_telemetry_cports(msg, cport);
+	case GB_TELEMETRY_TYPE_THREADS:
+		return gb_telemetry_threads(msg, cport);
+	default:
+		LOG_ERR("Invalid type");
+		gb_transport_message_empty_response_send(msg, GB_OP_INVALID, cport);
+	}
+}
+
+const struct gb_driver gb_telemetry_driver = {
+	.op_handler = gb_telemetry_handler,
+	/* A poller waits for each snapshot, deeper queues would only hold memory */
+	.queue_depth = 1,
+};
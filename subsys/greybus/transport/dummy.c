@@ -9,6 +9,7 @@
 #include <zephyr/kernel.h>
 #include <greybus-utils/manifest.h>
 #include "../greybus_internal.h"
+#include "../greybus_trace.h"
 
 K_MSGQ_DEFINE(rx_msgq, sizeof(struct gb_msg_with_cport), 2, 1);
 
@@ -24,18 +25,51 @@ static int listen(uint16_t cport)
 
 static int trans_send(uint16_t cport, const struct gb_message *msg)
 {
+	int ret;
 	const struct gb_msg_with_cport msg_copy = {
 		.cport = cport,
 		.msg = gb_message_copy(msg),
 	};
 
-	return k_msgq_put(&rx_msgq, &msg_copy, K_NO_WAIT);
+	if (!msg_copy.msg) {
+		return -ENOMEM;
+	}
+
+	ret = k_msgq_put(&rx_msgq, &msg_copy, K_NO_WAIT);
+	if (ret == 0) {
+		gb_trace(GB_TRACE_TRANSPORT_TX, cport, &msg->header);
+	} else {
+		gb_message_dealloc(msg_copy.msg);
+	}
+
+	return ret;
+}
+
+/* Message is queued as is, without copying it */
+static int trans_send_ref(uint16_t cport, struct gb_message *msg)
+{
+	int ret;
+	const struct gb_operation_msg_hdr hdr = msg->header;
+	const struct gb_msg_with_cport item = {
+		.cport = cport,
+		.msg = msg,
+	};
+
+	ret = k_msgq_put(&rx_msgq, &item, K_NO_WAIT);
+	if (ret == 0) {
+		gb_trace(GB_TRACE_TRANSPORT_TX, cport, &hdr);
+	} else {
+		gb_message_put(msg);
+	}
+
+	return ret;
 }
 
-const struct gb_transport_backend gb_trans_backend = {
+GB_TRANSPORT_BACKEND_DEFINE(dummy) = {
 	.init = init,
 	.listen = listen,
 	.send = trans_send,
+	.send_ref = trans_send_ref,
 };
 
 struct gb_msg_with_cport gb_transport_get_message(void)
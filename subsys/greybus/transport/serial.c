@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Greybus over a UART, using the asynchronous (DMA) UART API.
+ *
+ * Each message is sent as a GB_FRAME_HDLC frame, so a receiver which lost bytes resynchronizes on
+ * the next flag.
+ */
+
+#include <greybus/greybus.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <greybus/greybus_messages.h>
+#include "../greybus_frame.h"
+#include "../greybus_internal.h"
+#include "../greybus_trace.h"
+#include "../greybus_transport.h"
+#include "serial.h"
+
+LOG_MODULE_REGISTER(greybus_transport_serial, CONFIG_GREYBUS_LOG_LEVEL);
+
+#define GB_SERIAL_RX_STACK_SIZE     1024
+#define GB_SERIAL_RX_STACK_PRIORITY 6
+#define GB_SERIAL_TX_STACK_SIZE     1024
+#define GB_SERIAL_TX_STACK_PRIORITY 6
+/* Idle time after which received bytes are handed over before the DMA buffer is full */
+#define GB_SERIAL_RX_TIMEOUT_US     100
+
+K_THREAD_STACK_DEFINE(gb_serial_rx_stack, GB_SERIAL_RX_STACK_SIZE);
+K_THREAD_STACK_DEFINE(gb_serial_tx_stack, GB_SERIAL_TX_STACK_SIZE);
+
+/*
+ * struct gb_serial_tx_item: Message waiting to be transmitted
+ *
+ * @msg: greybus message held by reference
+ * @cport: cport of the message
+ */
+struct gb_serial_tx_item {
+	struct gb_message *msg;
+	uint16_t cport;
+};
+
+K_MSGQ_DEFINE(gb_serial_tx_queue, sizeof(struct gb_serial_tx_item),
+	      CONFIG_GREYBUS_SERIAL_TX_QUEUE_DEPTH, sizeof(void *));
+RING_BUF_DECLARE(gb_serial_rx_ring, CONFIG_GREYBUS_SERIAL_RX_RING_SIZE);
+
+/*
+ * struct gb_serial_ctx: Transport Context
+ *
+ * @dev: UART carrying greybus
+ * @rx_thread: thread decoding received bytes
+ * @tx_thread: thread which owns transmitting on dev
+ * @rx_sem: given when bytes are added to gb_serial_rx_ring
+ * @tx_done: given when a transmission completes
+ * @rx: frame decoder
+ * @tx: frame encoder of the message being transmitted
+ * @rx_frames: number of frames handed to greybus
+ * @rx_dropped: number of valid frames refused by greybus
+ * @rx_overruns: number of bytes lost because gb_serial_rx_ring was full, counted by the uart ISR
+ * @tx_frames: number of frames transmitted
+ * @rx_stopped: true once reception is disabled on purpose
+ * @rx_next: index of the DMA buffer handed to the driver next
+ * @rx_bufs: DMA buffers, one receiving while the other is drained
+ * @rx_buf: bytes taken from gb_serial_rx_ring by the rx thread, kept off its stack
+ * @tx_len: number of bytes in the current transmit buffer
+ * @tx_idx: index of the transmit buffer being filled
+ * @tx_bufs: transmit buffers, one being filled while the other is transmitted
+ */
+struct gb_serial_ctx {
+	const struct device *dev;
+	struct k_thread rx_thread;
+	struct k_thread tx_thread;
+	struct k_sem rx_sem;
+	struct k_sem tx_done;
+	struct gb_frame_decoder rx;
+	struct gb_frame_encoder tx;
+	atomic_t rx_frames;
+	atomic_t rx_dropped;
+	atomic_t rx_overruns;
+	atomic_t tx_frames;
+	bool rx_stopped;
+	uint8_t rx_next;
+	uint8_t rx_bufs[2][CONFIG_GREYBUS_SERIAL_RX_BUF_SIZE];
+	uint8_t rx_buf[CONFIG_GREYBUS_SERIAL_RX_BUF_SIZE];
+	size_t tx_len;
+	uint8_t tx_idx;
+	uint8_t tx_bufs[2][CONFIG_GREYBUS_SERIAL_TX_BUF_SIZE];
+};
+
+static struct gb_serial_ctx ctx = {
+	.dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_greybus_uart)),
+};
+
+static void gb_serial_uart_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+	int ret;
+	uint32_t written;
+	struct gb_serial_ctx *ctx = user_data;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		k_sem_give(&ctx->tx_done);
+		break;
+	case UART_RX_RDY:
+		written = ring_buf_put(&gb_serial_rx_ring, evt->data.rx.buf + evt->data.rx.offset,
+				       evt->data.rx.len);
+		atomic_add(&ctx->rx_overruns, evt->data.rx.len - written);
+		k_sem_give(&ctx->rx_sem);
+		break;
+	case UART_RX_BUF_REQUEST:
+		ret = uart_rx_buf_rsp(dev, ctx->rx_bufs[ctx->rx_next], sizeof(ctx->rx_bufs[0]));
+		if (ret == 0) {
+			ctx->rx_next ^= 1;
+		}
+		break;
+	case UART_RX_DISABLED:
+		if (ctx->rx_stopped) {
+			break;
+		}
+
+		/* Reception stops after line errors, keep listening */
+		ret = uart_rx_enable(dev, ctx->rx_bufs[ctx->rx_next], sizeof(ctx->rx_bufs[0]),
+				     GB_SERIAL_RX_TIMEOUT_US);
+		if (ret == 0) {
+			ctx->rx_next ^= 1;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void gb_serial_rx_deliver(struct gb_serial_ctx *ctx)
+{
+	int ret;
+	uint16_t cport;
+	struct gb_message *msg = gb_frame_decoder_pop(&ctx->rx, &cport);
+
+	if (!msg) {
+		return;
+	}
+
+	gb_trace(GB_TRACE_TRANSPORT_RX, cport, &msg->header);
+
+	ret = greybus_rx_handler(cport, msg);
+	if (ret < 0) {
+		LOG_ERR("Failed to receive greybus message");
+		gb_message_dealloc(msg);
+		atomic_inc(&ctx->rx_dropped);
+	} else {
+		atomic_inc(&ctx->rx_frames);
+	}
+}
+
+static void gb_serial_rx_decode(struct gb_serial_ctx *ctx, const uint8_t *data, size_t len)
+{
+	int ret;
+
+	while (len > 0) {
+		/* HDLC decoding never fails, corrupt frames are counted and dropped */
+		ret = gb_frame_decoder_push(&ctx->rx, data, len);
+		data += ret;
+		len -= ret;
+
+		gb_serial_rx_deliver(ctx);
+	}
+}
+
+/*
+ * Hander function for rx thread
+ */
+static void gb_serial_rx_thread_handler(void *p1, void *p2, void *p3)
+{
+	uint32_t len;
+
+	while (true) {
+		k_sem_take(&ctx.rx_sem, K_FOREVER);
+
+		while ((len = ring_buf_get(&gb_serial_rx_ring, ctx.rx_buf, sizeof(ctx.rx_buf)))) {
+			gb_serial_rx_decode(&ctx, ctx.rx_buf, len);
+		}
+	}
+}
+
+/*
+ * Helper to transmit the current buffer. The other buffer is filled while it is sent.
+ */
+static void gb_serial_tx_flush(struct gb_serial_ctx *ctx)
+{
+	int ret;
+
+	if (ctx->tx_len == 0) {
+		return;
+	}
+
+	/* Wait for the previous buffer to be sent */
+	k_sem_take(&ctx->tx_done, K_FOREVER);
+
+	ret = uart_tx(ctx->dev, ctx->tx_bufs[ctx->tx_idx], ctx->tx_len, SYS_FOREVER_US);
+	if (ret < 0) {
+		LOG_ERR("Failed to transmit data: %d", ret);
+		k_sem_give(&ctx->tx_done);
+	}
+
+	ctx->tx_idx ^= 1;
+	ctx->tx_len = 0;
+}
+
+static void gb_serial_tx_frame(struct gb_serial_ctx *ctx, uint16_t cport,
+			       const struct gb_message *msg)
+{
+	size_t len;
+	const size_t frame_max = GB_FRAME_HDLC_MAX_LEN(sys_le16_to_cpu(msg->header.size));
+
+	/* Start the frame in an empty buffer unless it fits even if every byte is escaped */
+	if (frame_max > sizeof(ctx->tx_bufs[0]) - ctx->tx_len) {
+		gb_serial_tx_flush(ctx);
+	}
+
+	gb_frame_encoder_init(&ctx->tx, GB_FRAME_HDLC, cport, msg);
+
+	/* Only frames larger than a whole buffer are split */
+	while (!gb_frame_encoder_done(&ctx->tx)) {
+		len = gb_frame_encoder_pull(&ctx->tx, ctx->tx_bufs[ctx->tx_idx] + ctx->tx_len,
+					    sizeof(ctx->tx_bufs[0]) - ctx->tx_len);
+		if (len == 0) {
+			/* No room left, not even for an escaped byte */
+			gb_serial_tx_flush(ctx);
+			continue;
+		}
+		ctx->tx_len += len;
+	}
+}
+
+/*
+ * Hander function for tx thread
+ */
+static void gb_serial_tx_thread_handler(void *p1, void *p2, void *p3)
+{
+	struct gb_serial_tx_item item;
+
+	while (true) {
+		k_msgq_get(&gb_serial_tx_queue, &item, K_FOREVER);
+
+		gb_serial_tx_frame(&ctx, item.cport, item.msg);
+		atomic_inc(&ctx.tx_frames);
+		gb_trace(GB_TRACE_TRANSPORT_TX, item.cport, &item.msg->header);
+		gb_message_put(item.msg);
+
+		/* Frames queued meanwhile share the buffer */
+		if (k_msgq_num_used_get(&gb_serial_tx_queue) == 0) {
+			gb_serial_tx_flush(&ctx);
+		}
+	}
+}
+
+static int gb_serial_listen_start(uint16_t cport)
+{
+	return 0;
+}
+
+static int gb_serial_listen_stop(uint16_t cport)
+{
+	return 0;
+}
+
+/*
+ * Queue a message for the tx thread by reference. This never blocks on the UART, so it is safe to
+ * call from any context, and frames from concurrent senders are never interleaved.
+ */
+static int gb_serial_send_ref(uint16_t cport, struct gb_message *msg)
+{
+	int ret;
+	const struct gb_serial_tx_item item = {
+		.msg = msg,
+		.cport = cport,
+	};
+
+	if (msg->header.result) {
+		LOG_INF("CPort %u, Type: %u, Result: %u, Id: %u", cport, msg->header.type,
+			msg->header.result, msg->header.operation_id);
+	}
+
+	ret = k_msgq_put(&gb_serial_tx_queue, &item, k_is_in_isr() ? K_NO_WAIT : K_FOREVER);
+	if (ret < 0) {
+		LOG_ERR("Transmit queue full");
+		gb_message_put(msg);
+	}
+
+	return ret;
+}
+
+/* In interrupts, the copy fails instead of waiting when memory is exhausted */
+static int gb_serial_send(uint16_t cport, const struct gb_message *msg)
+{
+	struct gb_message *copy = gb_message_copy(msg);
+
+	if (!copy) {
+		return -ENOMEM;
+	}
+
+	return gb_serial_send_ref(cport, copy);
+}
+
+void gb_serial_stats_get(struct gb_serial_stats *stats)
+{
+	stats->rx_frames = atomic_get(&ctx.rx_frames);
+	stats->rx_crc_errors = ctx.rx.stats.crc_errors;
+	stats->rx_framing_errors = ctx.rx.stats.framing_errors;
+	stats->rx_dropped = atomic_get(&ctx.rx_dropped) + ctx.rx.stats.dropped;
+	stats->rx_overruns = atomic_get(&ctx.rx_overruns);
+	stats->tx_frames = atomic_get(&ctx.tx_frames);
+}
+
+static int gb_serial_init(void)
+{
+	int ret;
+
+	if (!device_is_ready(ctx.dev)) {
+		LOG_ERR("Greybus UART is not ready");
+		return -ENODEV;
+	}
+
+	k_sem_init(&ctx.rx_sem, 0, 1);
+	/* No transmission is pending initially */
+	k_sem_init(&ctx.tx_done, 1, 1);
+	gb_frame_decoder_init(&ctx.rx, GB_FRAME_HDLC);
+
+	ret = uart_callback_set(ctx.dev, gb_serial_uart_cb, &ctx);
+	if (ret < 0) {
+		LOG_ERR("UART does not support the async API: %d", ret);
+		return ret;
+	}
+
+	ctx.rx_stopped = false;
+	ctx.rx_next = 1;
+	ret = uart_rx_enable(ctx.dev, ctx.rx_bufs[0], sizeof(ctx.rx_bufs[0]),
+			     GB_SERIAL_RX_TIMEOUT_US);
+	if (ret < 0) {
+		LOG_ERR("Failed to enable reception: %d", ret);
+		return ret;
+	}
+
+	k_thread_create(&ctx.tx_thread, gb_serial_tx_stack,
+			K_THREAD_STACK_SIZEOF(gb_serial_tx_stack), gb_serial_tx_thread_handler,
+			NULL, NULL, NULL, GB_SERIAL_TX_STACK_PRIORITY, 0, K_NO_WAIT);
+
+	k_thread_create(&ctx.rx_thread, gb_serial_rx_stack,
+			K_THREAD_STACK_SIZEOF(gb_serial_rx_stack), gb_serial_rx_thread_handler,
+			NULL, NULL, NULL, GB_SERIAL_RX_STACK_PRIORITY, 0, K_NO_WAIT);
+
+	return 0;
+}
+
+static void gb_serial_exit(void)
+{
+	struct gb_serial_tx_item item;
+
+	ctx.rx_stopped = true;
+	uart_rx_disable(ctx.dev);
+	uart_tx_abort(ctx.dev);
+
+	k_thread_abort(&ctx.rx_thread);
+	k_thread_abort(&ctx.tx_thread);
+
+	while (k_msgq_get(&gb_serial_tx_queue, &item, K_NO_WAIT) == 0) {
+		gb_message_put(item.msg);
+	}
+
+	gb_frame_decoder_reset(&ctx.rx);
+	ring_buf_reset(&gb_serial_rx_ring);
+}
+
+GB_TRANSPORT_BACKEND_DEFINE(serial) = {
+	.init = gb_serial_init,
+	.exit = gb_serial_exit,
+	.listen = gb_serial_listen_start,
+	.stop_listening = gb_serial_listen_stop,
+	.send = gb_serial_send,
+	.send_ref = gb_serial_send_ref,
+};
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GREYBUS_TRANSPORT_SERIAL_H_
+#define _GREYBUS_TRANSPORT_SERIAL_H_
+
+#include <stdint.h>
+
+/*
+ * struct gb_serial_stats: Serial transport counters
+ *
+ * @rx_frames: number of frames received and handed to greybus
+ * @rx_crc_errors: number of frames dropped for a bad frame check sequence
+ * @rx_framing_errors: number of frames dropped for being truncated, too long or badly escaped
+ * @rx_dropped: number of valid frames dropped for lack of memory or refused by greybus
+ * @rx_overruns: number of bytes lost because the receive ring buffer was full
+ * @tx_frames: number of frames transmitted
+ */
+struct gb_serial_stats {
+	uint32_t rx_frames;
+	uint32_t rx_crc_errors;
+	uint32_t rx_framing_errors;
+	uint32_t rx_dropped;
+	uint32_t rx_overruns;
+	uint32_t tx_frames;
+};
+
+/*
+ * Get counters of the serial transport.
+ *
+ * @param stats: output
+ */
+void gb_serial_stats_get(struct gb_serial_stats *stats);
+
+#endif // _GREYBUS_TRANSPORT_SERIAL_H_
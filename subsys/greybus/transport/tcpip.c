@@ -9,9 +9,15 @@
 #include <zephyr/net/dns_sd.h>
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/sys/mpsc_lockfree.h>
+#include <zephyr/sys/slist.h>
 #include "../platform/certificate.h"
 #include <greybus/greybus_messages.h>
+#include "../greybus_frame.h"
 #include "../greybus_internal.h"
+#include "../greybus_trace.h"
+#include "../greybus_transport.h"
+#include "tcpip.h"
 
 LOG_MODULE_REGISTER(greybus_transport_tcpip, CONFIG_GREYBUS_LOG_LEVEL);
 
@@ -21,11 +27,37 @@ LOG_MODULE_REGISTER(greybus_transport_tcpip, CONFIG_GREYBUS_LOG_LEVEL);
 #define CONFIG_GREYBUS_TLS_HOSTNAME ""
 #endif
 
+#ifndef CONFIG_GREYBUS_TCPIP_TX_COALESCE
+#define CONFIG_GREYBUS_TCPIP_TX_COALESCE_SIZE        0
+#define CONFIG_GREYBUS_TCPIP_TX_COALESCE_DEADLINE_US 0
+#endif
+
+#ifndef CONFIG_GREYBUS_TCPIP_CPORT_SOCKETS
+#define CONFIG_GREYBUS_TCPIP_CPORT_SOCKETS_MAX 0
+#endif
+
 /* Based on UniPro, from Linux */
 #define CPORT_ID_MAX 4095
 
 #define GB_TRANS_RX_STACK_SIZE     1024
 #define GB_TRANS_RX_STACK_PRIORITY 6
+#define GB_TRANS_TX_STACK_SIZE     1024
+#define GB_TRANS_TX_STACK_PRIORITY 6
+/* Maximum number of frames written by a single syscall */
+#define GB_TRANS_TX_BATCH_MAX      16
+/* The connection on the base port, which carries the control cport and any cport without its own */
+#define GB_TRANS_CONN_BASE         0
+#define GB_TRANS_CONN_COUNT        (1 + CONFIG_GREYBUS_TCPIP_CPORT_SOCKETS_MAX)
+/* One socket per connection, and the wakeup socket */
+#define GB_TRANS_POLL_MAX          (GB_TRANS_CONN_COUNT + 1)
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+/* Every cport has room for all the frames it can have waiting */
+#define GB_TRANS_TX_CPORT_SIZE SIZE_MAX
+#else
+/* Share of the transmit queue each cport can take, so a stalled socket cannot take all of it */
+#define GB_TRANS_TX_CPORT_SIZE                                                                     \
+	(CONFIG_GREYBUS_TCPIP_TX_QUEUE_SIZE / MAX(GREYBUS_CPORT_COUNT, 1))
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
 
 #ifdef CONFIG_GREYBUS_ENABLE_TLS
 DNS_SD_REGISTER_TCP_SERVICE(gb_service_advertisement, CONFIG_NET_HOSTNAME, "_greybuss", "local",
@@ -36,136 +68,679 @@ DNS_SD_REGISTER_TCP_SERVICE(gb_service_advertisement, CONFIG_NET_HOSTNAME, "_gre
 #endif /* CONFIG_GREYBUS_ENABLE_TLS */
 
 K_THREAD_STACK_DEFINE(gb_trans_rx_stack, GB_TRANS_RX_STACK_SIZE);
+K_THREAD_STACK_DEFINE(gb_trans_tx_stack, GB_TRANS_TX_STACK_SIZE);
+
+#ifndef CONFIG_GREYBUS_STATIC_MEMORY
+/* Backing memory for queued frames, which also bounds the queue length */
+static K_HEAP_DEFINE(gb_trans_tx_heap, CONFIG_GREYBUS_TCPIP_TX_QUEUE_SIZE);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
 
 /*
- * struct gb_trans_ctx: Transport Context
+ * struct gb_trans_tx_item: Frame waiting to be written to socket
  *
- * @rx_thread: rx_thread
+ * @node: entry in tx queue
+ * @pending: entry in the backlog of the connection the frame is written to
+ * @len: length of the frame
+ * @cport: cport of the message
+ * @msg: greybus message held by reference, written after @data. NULL if the message was copied
+ *	 into @data.
+ * @data: cport followed by greybus message, unless held in @msg
+ */
+struct gb_trans_tx_item {
+	struct mpsc_node node;
+	sys_snode_t pending;
+	size_t len;
+	uint16_t cport;
+	struct gb_message *msg;
+	uint8_t data[];
+};
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+/*
+ * Frames are held by reference to messages from the pool, so every item has the same size, and
+ * the frames each cport can have waiting bound their number.
+ */
+#define GB_TRANS_TX_ITEM_SIZE                                                                      \
+	ROUND_UP(sizeof(struct gb_trans_tx_item) + sizeof(__le16), sizeof(void *))
+#define GB_TRANS_TX_ITEM_COUNT (GREYBUS_CPORT_COUNT * CONFIG_GREYBUS_TCPIP_TX_CPORT_FRAMES)
+
+K_MEM_SLAB_DEFINE_STATIC(gb_trans_tx_slab, GB_TRANS_TX_ITEM_SIZE, GB_TRANS_TX_ITEM_COUNT,
+			 sizeof(void *));
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+/*
+ * struct gb_trans_conn: Connection carrying greybus frames
+ *
+ * @cport: cport with its own connection. Frames of any cport are accepted on the base connection.
+ * @used: true if the server socket is open
+ * @closing: true if the rx thread should close the sockets
  * @server_sock: socket on which the server listens for connections
- * @client_sock: socket with connection to a client
+ * @client_sock: socket with connection to a client. -1 if not connected.
+ * @tx_blocked: true while the client socket takes no more data. The rx thread polls it for
+ *		POLLOUT meanwhile.
+ * @tx_offset: number of bytes of the first frame in @tx_backlog already written
+ * @tx_backlog: frames waiting to be written to the client socket. Bounded by the frames and
+ *		queue memory each of its cports may have waiting.
+ * @rx: frame decoder
  */
-struct gb_trans_ctx {
-	struct k_thread rx_thread;
+struct gb_trans_conn {
+	uint16_t cport;
+	bool used;
+	bool closing;
 	int server_sock;
 	int client_sock;
+	bool tx_blocked;
+	size_t tx_offset;
+	sys_slist_t tx_backlog;
+	struct gb_frame_decoder rx;
+};
+
+/*
+ * struct gb_trans_ctx: Transport Context
+ *
+ * @rx_thread: thread which polls all connections
+ * @tx_thread: thread which owns writing to client sockets
+ * @tx_queue: frames waiting to be written to client sockets
+ * @tx_sem: number of frames in tx_queue
+ * @tx_writable: raised by the rx thread when a blocked client socket takes data again
+ * @tx_cport_frames: frames of each cport in tx_queue or a backlog
+ * @tx_cport_bytes: transmit queue memory taken by the frames of each cport
+ * @tx_refused: frames refused because their cport had too many frames waiting
+ * @tx_stats: transmit counters
+ * @conns_lock: protects the sockets and transmit backlogs of connections. The rx thread only
+ *		closes a socket with it held, so the tx thread never writes to a closed socket.
+ * @wake_sock: socket pair waking the rx thread when connections or blocked sockets change
+ * @conns: connections, GB_TRANS_CONN_BASE first
+ * @rx_buf: data received from client, shared by all connections since their decoders keep any
+ *	    partial frame
+ */
+struct gb_trans_ctx {
+	struct k_thread rx_thread;
+	struct k_thread tx_thread;
+	struct mpsc tx_queue;
+	struct k_sem tx_sem;
+	struct k_poll_signal tx_writable;
+	atomic_t tx_cport_frames[GREYBUS_CPORT_COUNT];
+	atomic_t tx_cport_bytes[GREYBUS_CPORT_COUNT];
+	atomic_t tx_refused;
+	struct gb_tcpip_tx_stats tx_stats;
+	struct k_mutex conns_lock;
+	int wake_sock[2];
+	struct gb_trans_conn conns[GB_TRANS_CONN_COUNT];
+	uint8_t rx_buf[CONFIG_GREYBUS_TCPIP_RX_BUF_SIZE];
 };
 
 static struct gb_trans_ctx ctx;
 
+static void gb_trans_rx_deliver(struct gb_trans_ctx *ctx, struct gb_trans_conn *conn)
+{
+	int ret;
+	uint16_t cport;
+	struct gb_message *msg = gb_frame_decoder_pop(&conn->rx, &cport);
+
+	if (!msg) {
+		return;
+	}
+
+	if (conn != &ctx->conns[GB_TRANS_CONN_BASE] && cport != conn->cport) {
+		LOG_ERR("Frame for cport %u on the socket of cport %u", cport, conn->cport);
+		gb_message_dealloc(msg);
+		return;
+	}
+
+	gb_trace(GB_TRACE_TRANSPORT_RX, cport, &msg->header);
+
+	ret = greybus_rx_handler(cport, msg);
+	if (ret < 0) {
+		LOG_ERR("Failed to receive greybus message");
+		gb_message_dealloc(msg);
+	}
+}
+
 /*
- * Helper to read data from socket
+ * Helper to parse all complete frames in the receive buffer. The rest of a payload which does not
+ * fit in the buffer is received directly into the message by the next reads.
+ *
+ * @return 0 if all complete frames were parsed.
+ * @return < 0 if the connection should be closed.
  */
-static int read_data(int sock, void *data, size_t len)
+static int gb_trans_rx_parse(struct gb_trans_ctx *ctx, struct gb_trans_conn *conn, size_t len)
 {
-	int ret, received = 0;
+	int ret;
+	size_t pos = 0;
 
-	while (received < len) {
-		ret = zsock_recv(sock, received + (char *)data, len - received, 0);
+	while (pos < len) {
+		ret = gb_frame_decoder_push(&conn->rx, ctx->rx_buf + pos, len - pos);
 		if (ret < 0) {
-			LOG_ERR("Failed to receive data");
+			LOG_ERR("Invalid message size");
 			return ret;
-		} else if (ret == 0) {
-			/* Socket was closed by peer */
-			return 0;
 		}
-		received += ret;
+
+		pos += ret;
+		gb_trans_rx_deliver(ctx, conn);
 	}
-	return received;
+
+	return 0;
 }
 
 /*
- * Helper to write data to socket
+ * Helper to take a place in the transmit queue for a frame of a cport. Each cport has at most
+ * CONFIG_GREYBUS_TCPIP_TX_CPORT_FRAMES frames and its share of the queue memory waiting, so a
+ * client which stops reading only holds back its own cports.
+ *
+ * @param size: queue memory taken by the frame
  */
-static int write_data(int sock, const void *data, size_t len)
+static int gb_trans_tx_reserve(uint16_t cport, size_t size)
 {
-	int ret, transmitted = 0;
+	atomic_val_t queued;
 
-	while (transmitted < len) {
-		ret = zsock_send(sock, transmitted + (char *)data, len - transmitted, 0);
-		if (ret < 0) {
-			LOG_ERR("Failed to transmit data");
-			return ret;
-		}
-		transmitted += ret;
+	if (cport >= GREYBUS_CPORT_COUNT) {
+		return -EINVAL;
+	}
+
+	/* atomic_inc and atomic_add return the previous value */
+	if (atomic_inc(&ctx.tx_cport_frames[cport]) >= CONFIG_GREYBUS_TCPIP_TX_CPORT_FRAMES) {
+		atomic_dec(&ctx.tx_cport_frames[cport]);
+		atomic_inc(&ctx.tx_refused);
+		return -EAGAIN;
+	}
+
+	/* A cport with nothing waiting can send a frame larger than its share */
+	queued = atomic_add(&ctx.tx_cport_bytes[cport], size);
+	if (queued != 0 && queued + size > GB_TRANS_TX_CPORT_SIZE) {
+		atomic_sub(&ctx.tx_cport_bytes[cport], size);
+		atomic_dec(&ctx.tx_cport_frames[cport]);
+		atomic_inc(&ctx.tx_refused);
+		return -EAGAIN;
 	}
-	return transmitted;
+
+	return 0;
+}
+
+static void gb_trans_tx_unreserve(uint16_t cport, size_t size)
+{
+	atomic_sub(&ctx.tx_cport_bytes[cport], size);
+	atomic_dec(&ctx.tx_cport_frames[cport]);
 }
 
+static struct gb_trans_tx_item *gb_trans_tx_item_alloc(size_t size)
+{
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+	void *item;
+
+	return k_mem_slab_alloc(&gb_trans_tx_slab, &item, K_NO_WAIT) == 0 ? item : NULL;
+#else
+	return k_heap_alloc(&gb_trans_tx_heap, size, K_NO_WAIT);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+}
+
+static int gb_trans_send_ref(uint16_t cport, struct gb_message *msg);
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+/*
+ * Queue a message for the tx thread. Items only hold messages by reference, so fragments are
+ * gathered into a message from the pool.
+ */
+static int gb_trans_send_iov(uint16_t cport, const struct gb_iovec *iov, size_t iovcnt)
+{
+	size_t i, len = 0;
+	uint8_t *pos;
+	struct gb_message *msg;
+
+	for (i = 0; i < iovcnt; i++) {
+		len += iov[i].len;
+	}
+
+	msg = gb_message_alloc(len - sizeof(struct gb_operation_msg_hdr), 0, 0, 0);
+	if (!msg) {
+		return -ENOMEM;
+	}
+
+	pos = (uint8_t *)&msg->header;
+	for (i = 0; i < iovcnt; i++) {
+		memcpy(pos, iov[i].base, iov[i].len);
+		pos += iov[i].len;
+	}
+
+	return gb_trans_send_ref(cport, msg);
+}
+#else
 /*
- * Helper to receive a greybus message from socket
+ * Queue a message for the tx thread. This never waits for the socket or for memory, so it is safe
+ * to call from any context, and frames from concurrent senders are never interleaved.
  */
-static struct gb_msg_with_cport gb_message_receive(int sock, bool *flag)
+static int gb_trans_send_iov(uint16_t cport, const struct gb_iovec *iov, size_t iovcnt)
 {
 	int ret;
-	struct gb_operation_msg_hdr hdr;
-	struct gb_msg_with_cport msg;
+	size_t i, len = sizeof(__le16);
+	struct gb_trans_tx_item *item;
+	const __le16 cport_u16 = sys_cpu_to_le16(cport);
+	const struct gb_operation_msg_hdr *hdr = iov[0].base;
+	uint8_t *pos;
 
-	ret = read_data(sock, &msg.cport, sizeof(msg.cport));
-	if (ret != sizeof(msg.cport)) {
-		*flag = ret == 0;
-		goto early_exit;
+	if (hdr->result) {
+		LOG_INF("CPort %u, Type: %u, Result: %u, Id: %u", cport, hdr->type, hdr->result,
+			hdr->operation_id);
 	}
-	msg.cport = sys_le16_to_cpu(msg.cport);
 
-	ret = read_data(sock, &hdr, sizeof(hdr));
-	if (ret != sizeof(hdr)) {
-		*flag = ret == 0;
-		goto early_exit;
+	for (i = 0; i < iovcnt; i++) {
+		len += iov[i].len;
 	}
 
-	msg.msg =
-		gb_message_alloc(gb_hdr_payload_len(&hdr), hdr.type, hdr.operation_id, hdr.result);
-	if (!msg.msg) {
-		LOG_ERR("Failed to allocate node message");
-		goto early_exit;
+	ret = gb_trans_tx_reserve(cport, sizeof(*item) + len);
+	if (ret < 0) {
+		return ret;
 	}
 
-	ret = read_data(sock, (uint8_t *)msg.msg + sizeof(hdr), gb_message_payload_len(msg.msg));
-	if (ret != gb_message_payload_len(msg.msg)) {
-		*flag = ret == 0;
-		goto free_msg;
+	item = gb_trans_tx_item_alloc(sizeof(*item) + len);
+	if (!item) {
+		LOG_ERR("Transmit queue full");
+		gb_trans_tx_unreserve(cport, sizeof(*item) + len);
+		return -ENOMEM;
 	}
 
-	return msg;
+	/* Fragments are gathered straight into the frame, so this is the only copy */
+	item->len = len;
+	item->cport = cport;
+	item->msg = NULL;
+	memcpy(item->data, &cport_u16, sizeof(cport_u16));
+	pos = item->data + sizeof(cport_u16);
+	for (i = 0; i < iovcnt; i++) {
+		memcpy(pos, iov[i].base, iov[i].len);
+		pos += iov[i].len;
+	}
 
-free_msg:
-	gb_message_dealloc(msg.msg);
-early_exit:
-	msg.cport = 0;
-	msg.msg = NULL;
-	return msg;
-}
+	mpsc_push(&ctx.tx_queue, &item->node);
+	k_sem_give(&ctx.tx_sem);
 
-static int gb_trans_listen_start(uint16_t cport)
-{
 	return 0;
 }
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
 
-static int gb_trans_listen_stop(uint16_t cport)
+static int gb_trans_send(uint16_t cport, const struct gb_message *msg)
 {
-	return 0;
+	const struct gb_iovec iov = {
+		.base = msg,
+		.len = sys_le16_to_cpu(msg->header.size),
+	};
+
+	return gb_trans_send_iov(cport, &iov, 1);
 }
 
-static int gb_trans_send(uint16_t cport, const struct gb_message *msg)
+/*
+ * Queue a message for the tx thread by reference, so only the cport is copied.
+ */
+static int gb_trans_send_ref(uint16_t cport, struct gb_message *msg)
 {
 	int ret;
-	__le16 cport_u16 = sys_cpu_to_le16(cport);
+	struct gb_trans_tx_item *item;
+	const __le16 cport_u16 = sys_cpu_to_le16(cport);
 
 	if (msg->header.result) {
 		LOG_INF("CPort %u, Type: %u, Result: %u, Id: %u", cport, msg->header.type,
 			msg->header.result, msg->header.operation_id);
 	}
 
-	ret = write_data(ctx.client_sock, &cport_u16, sizeof(cport_u16));
+	ret = gb_trans_tx_reserve(cport, sizeof(*item) + sizeof(cport_u16));
 	if (ret < 0) {
+		gb_message_put(msg);
 		return ret;
 	}
 
-	ret = write_data(ctx.client_sock, msg, sys_le16_to_cpu(msg->header.size));
-	return MIN(0, ret);
+	item = gb_trans_tx_item_alloc(sizeof(*item) + sizeof(cport_u16));
+	if (!item) {
+		LOG_ERR("Transmit queue full");
+		gb_trans_tx_unreserve(cport, sizeof(*item) + sizeof(cport_u16));
+		gb_message_put(msg);
+		return -ENOMEM;
+	}
+
+	item->len = sizeof(cport_u16) + sys_le16_to_cpu(msg->header.size);
+	item->cport = cport;
+	item->msg = msg;
+	memcpy(item->data, &cport_u16, sizeof(cport_u16));
+
+	mpsc_push(&ctx.tx_queue, &item->node);
+	k_sem_give(&ctx.tx_sem);
+
+	return 0;
+}
+
+static void gb_trans_tx_item_free(struct gb_trans_tx_item *item)
+{
+	/* Messages held by reference are not in the queue memory */
+	const size_t len = item->msg ? sizeof(__le16) : item->len;
+
+	gb_trans_tx_unreserve(item->cport, sizeof(*item) + len);
+	gb_message_put(item->msg);
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+	k_mem_slab_free(&gb_trans_tx_slab, item);
+#else
+	k_heap_free(&gb_trans_tx_heap, item);
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+}
+
+static struct gb_trans_tx_item *gb_trans_tx_pop(struct gb_trans_ctx *ctx)
+{
+	struct mpsc_node *node;
+
+	/*
+	 * A preempted producer which has not finished linking its node hides the nodes after it.
+	 * Sleep instead of yielding, since the producer can have lower priority than this thread.
+	 */
+	while ((node = mpsc_pop(&ctx->tx_queue)) == NULL) {
+		k_sleep(K_TICKS(1));
+	}
+
+	return CONTAINER_OF(node, struct gb_trans_tx_item, node);
+}
+
+/*
+ * Helper to check if the frames collected so far should be written right away
+ */
+static bool gb_trans_tx_flush_now(struct gb_trans_ctx *ctx, const struct gb_trans_tx_item *item,
+				  size_t count, size_t len)
+{
+	if (count == GB_TRANS_TX_BATCH_MAX) {
+		ctx->tx_stats.full_flushes++;
+		return true;
+	}
+
+	if (!IS_ENABLED(CONFIG_GREYBUS_TCPIP_TX_COALESCE)) {
+		return false;
+	}
+
+	if (item->cport == GB_CONTROL_CPORT_ID) {
+		ctx->tx_stats.control_flushes++;
+		return true;
+	}
+
+	if (len >= CONFIG_GREYBUS_TCPIP_TX_COALESCE_SIZE) {
+		ctx->tx_stats.full_flushes++;
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * Helper to wait for the next frame to write together with the ones collected so far
+ */
+static int gb_trans_tx_wait_more(struct gb_trans_ctx *ctx, k_timepoint_t deadline)
+{
+	if (!IS_ENABLED(CONFIG_GREYBUS_TCPIP_TX_COALESCE)) {
+		return k_sem_take(&ctx->tx_sem, K_NO_WAIT);
+	}
+
+	if (k_sem_take(&ctx->tx_sem, sys_timepoint_timeout(deadline)) < 0) {
+		ctx->tx_stats.deadline_flushes++;
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+/*
+ * Helper to get the connection frames of a cport are written to. Called with conns_lock held.
+ *
+ * @return NULL if the cport has no connected client.
+ */
+static struct gb_trans_conn *gb_trans_tx_conn(struct gb_trans_ctx *ctx, uint16_t cport)
+{
+	size_t i;
+	struct gb_trans_conn *base = &ctx->conns[GB_TRANS_CONN_BASE];
+
+	for (i = GB_TRANS_CONN_BASE + 1; i < ARRAY_SIZE(ctx->conns); i++) {
+		if (ctx->conns[i].used && ctx->conns[i].cport == cport &&
+		    ctx->conns[i].client_sock != -1) {
+			return &ctx->conns[i];
+		}
+	}
+
+	return base->client_sock != -1 ? base : NULL;
+}
+
+/*
+ * Helper to describe a frame with iovecs
+ *
+ * @return number of iovecs used
+ */
+static size_t gb_trans_tx_item_iov(const struct gb_trans_tx_item *item, struct iovec *iov)
+{
+	iov[0].iov_base = (void *)item->data;
+	if (!item->msg) {
+		iov[0].iov_len = item->len;
+		return 1;
+	}
+
+	iov[0].iov_len = sizeof(__le16);
+	iov[1].iov_base = item->msg;
+	iov[1].iov_len = item->len - sizeof(__le16);
+
+	return 2;
+}
+
+/*
+ * Helper to skip bytes at the start of iovecs
+ */
+static void gb_trans_iov_skip(struct msghdr *msg, size_t len)
+{
+	while (msg->msg_iovlen && len >= msg->msg_iov->iov_len) {
+		len -= msg->msg_iov->iov_len;
+		msg->msg_iov++;
+		msg->msg_iovlen--;
+	}
+
+	if (msg->msg_iovlen) {
+		msg->msg_iov->iov_base = (uint8_t *)msg->msg_iov->iov_base + len;
+		msg->msg_iov->iov_len -= len;
+	}
+}
+
+/*
+ * Helper to trace and free a frame which has been written completely
+ */
+static void gb_trans_tx_item_sent(struct gb_trans_tx_item *item)
+{
+	const struct gb_operation_msg_hdr *hdr =
+		item->msg ? &item->msg->header
+			  : (const struct gb_operation_msg_hdr *)(item->data + sizeof(__le16));
+
+	gb_trace(GB_TRACE_TRANSPORT_TX, item->cport, hdr);
+	gb_trans_tx_item_free(item);
+}
+
+/*
+ * Helper to free the frames of a backlog which have been written completely
+ *
+ * @param len: number of bytes written after tx_offset
+ */
+static void gb_trans_tx_consume(struct gb_trans_conn *conn, size_t len)
+{
+	sys_snode_t *node;
+	struct gb_trans_tx_item *item;
+
+	len += conn->tx_offset;
+	while ((node = sys_slist_peek_head(&conn->tx_backlog)) != NULL) {
+		item = CONTAINER_OF(node, struct gb_trans_tx_item, pending);
+		if (len < item->len) {
+			break;
+		}
+
+		len -= item->len;
+		sys_slist_get_not_empty(&conn->tx_backlog);
+		gb_trans_tx_item_sent(item);
+	}
+
+	conn->tx_offset = len;
+}
+
+/*
+ * Helper to drop all frames waiting for a connection
+ */
+static void gb_trans_tx_drop(struct gb_trans_conn *conn)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(&conn->tx_backlog)) != NULL) {
+		gb_trans_tx_item_free(CONTAINER_OF(node, struct gb_trans_tx_item, pending));
+	}
+
+	conn->tx_offset = 0;
+	conn->tx_blocked = false;
+}
+
+static void gb_trans_wake(struct gb_trans_ctx *ctx);
+
+/*
+ * Helper to write the backlog of a connection, as far as the socket takes it without blocking.
+ * Called with conns_lock held. A socket which takes no more data is polled by the rx thread, so
+ * that it does not delay the other sockets.
+ */
+static void gb_trans_tx_flush_conn(struct gb_trans_ctx *ctx, struct gb_trans_conn *conn)
+{
+	ssize_t ret;
+	size_t iovcnt;
+	sys_snode_t *node;
+	struct msghdr msg = {0};
+	/* Messages held by reference take a second entry */
+	struct iovec iov[GB_TRANS_TX_BATCH_MAX * 2];
+
+	while (!conn->tx_blocked && !sys_slist_is_empty(&conn->tx_backlog)) {
+		iovcnt = 0;
+		SYS_SLIST_FOR_EACH_NODE(&conn->tx_backlog, node) {
+			if (iovcnt + 2 > ARRAY_SIZE(iov)) {
+				break;
+			}
+			iovcnt += gb_trans_tx_item_iov(
+				CONTAINER_OF(node, struct gb_trans_tx_item, pending), iov + iovcnt);
+		}
+
+		msg.msg_iov = iov;
+		msg.msg_iovlen = iovcnt;
+		gb_trans_iov_skip(&msg, conn->tx_offset);
+
+		ret = zsock_sendmsg(conn->client_sock, &msg, ZSOCK_MSG_DONTWAIT);
+		if (ret == 0 || (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) {
+			conn->tx_blocked = true;
+			ctx->tx_stats.blocked_writes++;
+			gb_trans_wake(ctx);
+			return;
+		}
+
+		if (ret < 0) {
+			/* The rx thread notices the failure and closes the socket */
+			LOG_ERR("Failed to send frames: %d", errno);
+			gb_trans_tx_drop(conn);
+			return;
+		}
+
+		gb_trans_tx_consume(conn, ret);
+	}
+}
+
+/*
+ * Helper to write the backlogs of all connections. Called with conns_lock held.
+ */
+static void gb_trans_tx_flush(struct gb_trans_ctx *ctx)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		if (ctx->conns[i].used && ctx->conns[i].client_sock != -1) {
+			gb_trans_tx_flush_conn(ctx, &ctx->conns[i]);
+		}
+	}
+}
+
+/*
+ * Helper to write collected frames. Frames for the same socket are written together.
+ */
+static void gb_trans_tx_write(struct gb_trans_ctx *ctx, struct gb_trans_tx_item **items,
+			      size_t count)
+{
+	size_t i;
+	struct gb_trans_conn *conn;
+
+	k_mutex_lock(&ctx->conns_lock, K_FOREVER);
+
+	for (i = 0; i < count; i++) {
+		conn = gb_trans_tx_conn(ctx, items[i]->cport);
+
+		/* Frames are dropped while no client is connected */
+		if (!conn) {
+			gb_trans_tx_item_free(items[i]);
+			continue;
+		}
+
+		sys_slist_append(&conn->tx_backlog, &items[i]->pending);
+	}
+
+	gb_trans_tx_flush(ctx);
+
+	k_mutex_unlock(&ctx->conns_lock);
+}
+
+/*
+ * Hander function for tx thread
+ */
+static void gb_trans_tx_thread_handler(void *p1, void *p2, void *p3)
+{
+	size_t count, len;
+	k_timepoint_t deadline;
+	struct gb_trans_tx_item *items[GB_TRANS_TX_BATCH_MAX];
+	struct k_poll_event events[2];
+
+	k_poll_event_init(&events[0], K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+			  &ctx.tx_sem);
+	k_poll_event_init(&events[1], K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+			  &ctx.tx_writable);
+
+	while (true) {
+		k_poll(events, ARRAY_SIZE(events), K_FOREVER);
+
+		/* Blocked sockets take data again */
+		if (events[1].state == K_POLL_STATE_SIGNALED) {
+			k_poll_signal_reset(&ctx.tx_writable);
+			k_mutex_lock(&ctx.conns_lock, K_FOREVER);
+			gb_trans_tx_flush(&ctx);
+			k_mutex_unlock(&ctx.conns_lock);
+		}
+		events[0].state = K_POLL_STATE_NOT_READY;
+		events[1].state = K_POLL_STATE_NOT_READY;
+
+		if (k_sem_take(&ctx.tx_sem, K_NO_WAIT) < 0) {
+			continue;
+		}
+
+		/* The first frame is held for at most the coalescing deadline */
+		deadline = sys_timepoint_calc(K_USEC(CONFIG_GREYBUS_TCPIP_TX_COALESCE_DEADLINE_US));
+
+		/* Send all collected frames in as few syscalls per socket as possible */
+		count = 0;
+		len = 0;
+		do {
+			items[count] = gb_trans_tx_pop(&ctx);
+			len += items[count]->len;
+			count++;
+		} while (!gb_trans_tx_flush_now(&ctx, items[count - 1], count, len) &&
+			 gb_trans_tx_wait_more(&ctx, deadline) == 0);
+
+		ctx.tx_stats.flushes++;
+		ctx.tx_stats.frames += count;
+		ctx.tx_stats.max_frames_per_flush = MAX(ctx.tx_stats.max_frames_per_flush, count);
+
+		gb_trans_tx_write(&ctx, items, count);
+	}
+}
+
+void gb_tcpip_tx_stats_get(struct gb_tcpip_tx_stats *stats)
+{
+	*stats = ctx.tx_stats;
+	stats->refused = atomic_get(&ctx.tx_refused);
 }
 
-static int netsetup()
+static int netsetup(uint16_t port)
 {
 	int sock, ret, family, proto = IPPROTO_TCP;
 	const int yes = true;
@@ -181,13 +756,13 @@ static int netsetup()
 		family = AF_INET6;
 		net_sin6(&sa)->sin6_family = AF_INET6;
 		net_sin6(&sa)->sin6_addr = in6addr_any;
-		net_sin6(&sa)->sin6_port = htons(GB_TRANSPORT_TCPIP_BASE_PORT);
+		net_sin6(&sa)->sin6_port = htons(port);
 		sa_len = sizeof(struct sockaddr_in6);
 	} else if (IS_ENABLED(CONFIG_NET_IPV4)) {
 		family = AF_INET;
 		net_sin(&sa)->sin_family = AF_INET;
 		net_sin(&sa)->sin_addr.s_addr = INADDR_ANY;
-		net_sin(&sa)->sin_port = htons(GB_TRANSPORT_TCPIP_BASE_PORT);
+		net_sin(&sa)->sin_port = htons(port);
 		sa_len = sizeof(struct sockaddr_in);
 	} else {
 		LOG_ERR("Neither IPv6 nor IPv4 is available");
@@ -203,7 +778,7 @@ static int netsetup()
 	ret = zsock_setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
 	if (ret < 0) {
 		LOG_ERR("setsockopt: Failed to set SO_REUSEADDR (%d)", errno);
-		return -errno;
+		goto err;
 	}
 
 	if (IS_ENABLED(CONFIG_GREYBUS_ENABLE_TLS)) {
@@ -219,14 +794,14 @@ static int netsetup()
 				       sizeof(sec_tag_opt));
 		if (ret < 0) {
 			LOG_ERR("setsockopt: Failed to set SEC_TAG_LIST (%d)", errno);
-			return -errno;
+			goto err;
 		}
 
 		ret = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, CONFIG_GREYBUS_TLS_HOSTNAME,
 				       strlen(CONFIG_GREYBUS_TLS_HOSTNAME));
 		if (ret < 0) {
 			LOG_ERR("setsockopt: Failed to set TLS_HOSTNAME (%d)", errno);
-			return -errno;
+			goto err;
 		}
 
 		/* default to no client verification */
@@ -243,125 +818,376 @@ static int netsetup()
 		ret = zsock_setsockopt(sock, SOL_TLS, TLS_PEER_VERIFY, &verify, sizeof(verify));
 		if (ret < 0) {
 			LOG_ERR("setsockopt: Failed to set TLS_PEER_VERIFY (%d)", errno);
-			return -errno;
+			goto err;
 		}
 	}
 
 	ret = zsock_bind(sock, &sa, sa_len);
 	if (ret < 0) {
 		LOG_ERR("bind: %d", errno);
-		return -errno;
+		goto err;
 	}
 
 	/* We will only ever be connected to a single ap */
 	ret = zsock_listen(sock, 1);
 	if (ret < 0) {
 		LOG_ERR("listen: %d", errno);
-		return -errno;
+		goto err;
 	}
 
-	LOG_INF("Greybus socket opened at port %zu", htons(GB_TRANSPORT_TCPIP_BASE_PORT));
+	LOG_INF("Greybus socket opened at port %u", port);
 
 	return sock;
+
+err:
+	ret = -errno;
+	zsock_close(sock);
+	return ret;
 }
 
 /*
  * Helper to accept new connection
  */
-static void gb_trans_accept(struct gb_trans_ctx *ctx)
+static void gb_trans_accept(struct gb_trans_ctx *ctx, struct gb_trans_conn *conn)
 {
-	int ret;
-	struct zsock_pollfd fd = {
-		.fd = ctx->server_sock,
-		.events = ZSOCK_POLLIN,
-	};
+	int ret, sock;
+	const int yes = true;
 	struct sockaddr_in6 addr = {
 		.sin6_family = AF_INET6,
 		.sin6_addr = in6addr_any,
 	};
 	socklen_t addrlen = sizeof(addr);
 
-	ret = zsock_poll(&fd, 1, -1);
-	if (ret < 0) {
-		LOG_ERR("Socket poll failed");
+	sock = zsock_accept(conn->server_sock, (struct sockaddr *)&addr, &addrlen);
+	if (sock < 0) {
+		LOG_ERR("Failed to accept connection");
 		return;
 	}
 
-	if (fd.revents & ZSOCK_POLLIN) {
-		ret = zsock_accept(fd.fd, (struct sockaddr *)&addr, &addrlen);
+	/* Frames are already coalesced here, so waiting in the stack only adds latency */
+	if (IS_ENABLED(CONFIG_GREYBUS_TCPIP_TX_COALESCE)) {
+		ret = zsock_setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
 		if (ret < 0) {
-			LOG_ERR("Failed to accept connection");
-			return;
+			LOG_WRN("setsockopt: Failed to set TCP_NODELAY (%d)", errno);
 		}
-		ctx->client_sock = ret;
 	}
 
-	LOG_INF("Accepted new connection");
+	k_mutex_lock(&ctx->conns_lock, K_FOREVER);
+	conn->client_sock = sock;
+	k_mutex_unlock(&ctx->conns_lock);
+
+	LOG_INF("Accepted new connection for cport %u", conn->cport);
+}
+
+/*
+ * Helper to close the client socket of a connection, and drop the frames not written to it. Called
+ * with conns_lock held.
+ */
+static void gb_trans_disconnect(struct gb_trans_conn *conn)
+{
+	zsock_close(conn->client_sock);
+	conn->client_sock = -1;
+	gb_frame_decoder_reset(&conn->rx);
+	gb_trans_tx_drop(conn);
 }
 
 /*
- * Helper to receive messages if socket connection is established
+ * Helper to receive what is available on an established connection. The rest of a large payload
+ * is received directly into the message as it arrives, while the other sockets are polled.
  */
-static void gb_trans_rx(struct gb_trans_ctx *ctx)
+static void gb_trans_rx(struct gb_trans_ctx *ctx, struct gb_trans_conn *conn)
 {
 	int ret;
-	bool flag = false;
-	struct gb_msg_with_cport msg;
-	struct zsock_pollfd fd = {
-		.fd = ctx->client_sock,
-		.events = ZSOCK_POLLIN,
-	};
+	size_t missing;
+	uint8_t *buf;
+
+	missing = gb_frame_decoder_payload_buf(&conn->rx, &buf);
+	if (missing) {
+		ret = zsock_recv(conn->client_sock, buf, missing, ZSOCK_MSG_DONTWAIT);
+	} else {
+		ret = zsock_recv(conn->client_sock, ctx->rx_buf, sizeof(ctx->rx_buf),
+				 ZSOCK_MSG_DONTWAIT);
+	}
+
+	if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		/* E.g. only part of a TLS record has arrived */
+		return;
+	}
 
-	ret = zsock_poll(&fd, 1, -1);
 	if (ret < 0) {
-		LOG_ERR("Socket poll failed");
+		LOG_ERR("Failed to receive data (%d)", errno);
+	} else if (ret > 0 && missing) {
+		gb_frame_decoder_payload_commit(&conn->rx, ret);
+		gb_trans_rx_deliver(ctx, conn);
+		return;
+	} else if (ret > 0 && gb_trans_rx_parse(ctx, conn, ret) == 0) {
 		return;
 	}
 
-	if (fd.revents & ZSOCK_POLLIN) {
-		msg = gb_message_receive(fd.fd, &flag);
-		if (flag) {
-			zsock_close(fd.fd);
-			ctx->client_sock = -1;
-			return;
+	/* Socket was closed by peer, or failed */
+	k_mutex_lock(&ctx->conns_lock, K_FOREVER);
+	gb_trans_disconnect(conn);
+	k_mutex_unlock(&ctx->conns_lock);
+}
+
+/*
+ * Helper to let the tx thread write to a blocked socket again
+ */
+static void gb_trans_tx_unblock(struct gb_trans_ctx *ctx, struct gb_trans_conn *conn)
+{
+	k_mutex_lock(&ctx->conns_lock, K_FOREVER);
+	conn->tx_blocked = false;
+	k_mutex_unlock(&ctx->conns_lock);
+
+	k_poll_signal_raise(&ctx->tx_writable, 0);
+}
+
+/*
+ * Helper to wake the rx thread, so that it polls the connections again
+ */
+static void gb_trans_wake(struct gb_trans_ctx *ctx)
+{
+	const uint8_t byte = 0;
+
+	/* A full socket pair already wakes the rx thread */
+	(void)zsock_send(ctx->wake_sock[1], &byte, sizeof(byte), ZSOCK_MSG_DONTWAIT);
+}
+
+static void gb_trans_wake_drain(struct gb_trans_ctx *ctx)
+{
+	uint8_t buf[8];
+
+	while (zsock_recv(ctx->wake_sock[0], buf, sizeof(buf), ZSOCK_MSG_DONTWAIT) > 0) {
+	}
+}
+
+/*
+ * Helper to close connections stopped by gb_trans_listen_stop, and collect the sockets to poll.
+ * The server socket is only polled while no client is connected, and a client socket is polled for
+ * POLLOUT while it blocks the tx thread.
+ *
+ * @return number of sockets to poll. Entries of conns are NULL for the wakeup socket.
+ */
+static size_t gb_trans_poll_setup(struct gb_trans_ctx *ctx, struct zsock_pollfd *fds,
+				  struct gb_trans_conn **conns)
+{
+	size_t i, nfds = 0;
+	struct gb_trans_conn *conn;
+
+	k_mutex_lock(&ctx->conns_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		conn = &ctx->conns[i];
+		if (conn->used && conn->closing) {
+			if (conn->client_sock != -1) {
+				gb_trans_disconnect(conn);
+			}
+			zsock_close(conn->server_sock);
+			conn->used = false;
+			LOG_INF("Closed socket of cport %u", conn->cport);
 		}
 
-		if (!msg.msg) {
-			LOG_ERR("Failed to receive message");
-			return;
+		if (!conn->used) {
+			continue;
 		}
 
-		ret = greybus_rx_handler(msg.cport, msg.msg);
-		if (ret < 0) {
-			LOG_ERR("Failed to receive greybus message");
-			gb_message_dealloc(msg.msg);
+		fds[nfds].fd = conn->client_sock != -1 ? conn->client_sock : conn->server_sock;
+		fds[nfds].events = ZSOCK_POLLIN;
+		if (conn->client_sock != -1 && conn->tx_blocked) {
+			fds[nfds].events |= ZSOCK_POLLOUT;
 		}
+		conns[nfds++] = conn;
 	}
+
+	k_mutex_unlock(&ctx->conns_lock);
+
+	fds[nfds].fd = ctx->wake_sock[0];
+	fds[nfds].events = ZSOCK_POLLIN;
+	conns[nfds++] = NULL;
+
+	return nfds;
 }
 
 /*
- * Hander function for rx thread
+ * Hander function for rx thread. A single thread polls all connections, and only receives what is
+ * available, so a large frame on one cport socket does not delay frames on the others.
  */
 static void gb_trans_rx_thread_handler(void *p1, void *p2, void *p3)
 {
+	int ret;
+	size_t i, nfds;
+	struct zsock_pollfd fds[GB_TRANS_POLL_MAX];
+	struct gb_trans_conn *conns[GB_TRANS_POLL_MAX];
+
 	while (true) {
-		if (ctx.client_sock == -1) {
-			gb_trans_accept(&ctx);
+		nfds = gb_trans_poll_setup(&ctx, fds, conns);
+
+		ret = zsock_poll(fds, nfds, -1);
+		if (ret < 0) {
+			LOG_ERR("Socket poll failed");
+			continue;
+		}
+
+		for (i = 0; i < nfds; i++) {
+			if (fds[i].revents & ZSOCK_POLLOUT) {
+				gb_trans_tx_unblock(&ctx, conns[i]);
+			}
+
+			/* A closed or failed connection is noticed by the next receive */
+			if (!(fds[i].revents & (ZSOCK_POLLIN | ZSOCK_POLLHUP | ZSOCK_POLLERR))) {
+				continue;
+			}
+
+			if (!conns[i]) {
+				gb_trans_wake_drain(&ctx);
+			} else if (fds[i].fd == conns[i]->server_sock) {
+				gb_trans_accept(&ctx, conns[i]);
+			} else {
+				gb_trans_rx(&ctx, conns[i]);
+			}
+		}
+	}
+}
+
+static struct gb_trans_conn *gb_trans_conn_find(struct gb_trans_ctx *ctx, uint16_t cport)
+{
+	size_t i;
+
+	for (i = GB_TRANS_CONN_BASE + 1; i < ARRAY_SIZE(ctx->conns); i++) {
+		if (ctx->conns[i].used && ctx->conns[i].cport == cport) {
+			return &ctx->conns[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct gb_trans_conn *gb_trans_conn_alloc(struct gb_trans_ctx *ctx, uint16_t cport)
+{
+	size_t i;
+	int sock;
+	struct gb_trans_conn *conn;
+
+	for (i = GB_TRANS_CONN_BASE + 1; i < ARRAY_SIZE(ctx->conns); i++) {
+		conn = &ctx->conns[i];
+		if (conn->used) {
+			continue;
+		}
+
+		sock = netsetup(GB_TRANSPORT_TCPIP_BASE_PORT + cport);
+		if (sock < 0) {
+			return NULL;
+		}
+
+		conn->cport = cport;
+		conn->closing = false;
+		conn->server_sock = sock;
+		conn->client_sock = -1;
+		conn->tx_blocked = false;
+		conn->tx_offset = 0;
+		sys_slist_init(&conn->tx_backlog);
+		gb_frame_decoder_init(&conn->rx, GB_FRAME_STREAM);
+		conn->used = true;
+
+		return conn;
+	}
+
+	return NULL;
+}
+
+/*
+ * Open the socket of a cport on GB_TRANSPORT_TCPIP_BASE_PORT + cport. The socket is ready when
+ * this returns, so the AP can connect as soon as it gets the response to CONNECTED. A cport which
+ * cannot get its own socket keeps using the base connection.
+ */
+static int gb_trans_listen_start(uint16_t cport)
+{
+	struct gb_trans_conn *conn;
+
+	if (!IS_ENABLED(CONFIG_GREYBUS_TCPIP_CPORT_SOCKETS) || cport == GB_CONTROL_CPORT_ID) {
+		return 0;
+	}
+
+	k_mutex_lock(&ctx.conns_lock, K_FOREVER);
+
+	conn = gb_trans_conn_find(&ctx, cport);
+	if (conn) {
+		/* Connected again before the rx thread closed it */
+		conn->closing = false;
+	} else {
+		conn = gb_trans_conn_alloc(&ctx, cport);
+		if (conn) {
+			gb_trans_wake(&ctx);
 		} else {
-			gb_trans_rx(&ctx);
+			LOG_WRN("No socket for cport %u, using the base connection", cport);
 		}
 	}
+
+	k_mutex_unlock(&ctx.conns_lock);
+
+	return 0;
+}
+
+/*
+ * Close the socket of a cport. Sockets are only closed by the rx thread, which may be polling them.
+ */
+static int gb_trans_listen_stop(uint16_t cport)
+{
+	struct gb_trans_conn *conn;
+
+	if (!IS_ENABLED(CONFIG_GREYBUS_TCPIP_CPORT_SOCKETS) || cport == GB_CONTROL_CPORT_ID) {
+		return 0;
+	}
+
+	k_mutex_lock(&ctx.conns_lock, K_FOREVER);
+
+	conn = gb_trans_conn_find(&ctx, cport);
+	if (conn) {
+		conn->closing = true;
+		gb_trans_wake(&ctx);
+	}
+
+	k_mutex_unlock(&ctx.conns_lock);
+
+	return 0;
 }
 
 static int gb_trans_init(void)
 {
-	ctx.server_sock = netsetup();
+	int ret;
+	struct gb_trans_conn *base = &ctx.conns[GB_TRANS_CONN_BASE];
+
+	k_mutex_init(&ctx.conns_lock);
 
-	if (ctx.server_sock < 0) {
+	ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, ctx.wake_sock);
+	if (ret < 0) {
+		LOG_ERR("Failed to create wakeup socket pair (%d)", errno);
+		return -errno;
+	}
+
+	base->server_sock = netsetup(GB_TRANSPORT_TCPIP_BASE_PORT);
+	if (base->server_sock < 0) {
 		LOG_ERR("Failed to setup base TCP port");
+		zsock_close(ctx.wake_sock[0]);
+		zsock_close(ctx.wake_sock[1]);
 		return -ESOCKTNOSUPPORT;
 	}
-	ctx.client_sock = -1;
+	base->cport = GB_CONTROL_CPORT_ID;
+	base->client_sock = -1;
+	base->closing = false;
+	base->tx_blocked = false;
+	base->tx_offset = 0;
+	sys_slist_init(&base->tx_backlog);
+	gb_frame_decoder_init(&base->rx, GB_FRAME_STREAM);
+	base->used = true;
+
+	mpsc_init(&ctx.tx_queue);
+	k_sem_init(&ctx.tx_sem, 0, K_SEM_MAX_LIMIT);
+	k_poll_signal_init(&ctx.tx_writable);
+
+	k_thread_create(&ctx.tx_thread, gb_trans_tx_stack, K_THREAD_STACK_SIZEOF(gb_trans_tx_stack),
+			gb_trans_tx_thread_handler, NULL, NULL, NULL, GB_TRANS_TX_STACK_PRIORITY, 0,
+			K_NO_WAIT);
 
 	k_thread_create(&ctx.rx_thread, gb_trans_rx_stack, K_THREAD_STACK_SIZEOF(gb_trans_rx_stack),
 			gb_trans_rx_thread_handler, NULL, NULL, NULL, GB_TRANS_RX_STACK_PRIORITY, 0,
@@ -372,15 +1198,40 @@ static int gb_trans_init(void)
 
 static void gb_trans_exit(void)
 {
+	size_t i;
+	struct mpsc_node *node;
+	struct gb_trans_conn *conn;
+
 	k_thread_abort(&ctx.rx_thread);
-	zsock_close(ctx.server_sock);
-	zsock_close(ctx.client_sock);
+	k_thread_abort(&ctx.tx_thread);
+
+	while ((node = mpsc_pop(&ctx.tx_queue)) != NULL) {
+		gb_trans_tx_item_free(CONTAINER_OF(node, struct gb_trans_tx_item, node));
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctx.conns); i++) {
+		conn = &ctx.conns[i];
+		if (!conn->used) {
+			continue;
+		}
+
+		if (conn->client_sock != -1) {
+			gb_trans_disconnect(conn);
+		}
+		zsock_close(conn->server_sock);
+		conn->used = false;
+	}
+
+	zsock_close(ctx.wake_sock[0]);
+	zsock_close(ctx.wake_sock[1]);
 }
 
-const struct gb_transport_backend gb_trans_backend = {
+GB_TRANSPORT_BACKEND_DEFINE(tcpip) = {
 	.init = gb_trans_init,
 	.exit = gb_trans_exit,
 	.listen = gb_trans_listen_start,
 	.stop_listening = gb_trans_listen_stop,
 	.send = gb_trans_send,
+	.send_iov = gb_trans_send_iov,
+	.send_ref = gb_trans_send_ref,
 };
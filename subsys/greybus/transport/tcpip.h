@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GREYBUS_TRANSPORT_TCPIP_H_
+#define _GREYBUS_TRANSPORT_TCPIP_H_
+
+#include <stdint.h>
+
+/*
+ * struct gb_tcpip_tx_stats: TCP/IP transport transmit counters
+ *
+ * @flushes: number of writes to the socket
+ * @frames: number of frames written
+ * @max_frames_per_flush: largest number of frames written together
+ * @control_flushes: writes started early by a control cport frame
+ * @full_flushes: writes started early because enough data was pending
+ * @deadline_flushes: writes started by the coalescing deadline
+ * @blocked_writes: writes a client socket did not take, while the other sockets were written
+ * @refused: frames refused because their cport had too many frames, or its share of the queue
+ *	     memory, waiting
+ */
+struct gb_tcpip_tx_stats {
+	uint32_t flushes;
+	uint32_t frames;
+	uint32_t max_frames_per_flush;
+	uint32_t control_flushes;
+	uint32_t full_flushes;
+	uint32_t deadline_flushes;
+	uint32_t blocked_writes;
+	uint32_t refused;
+};
+
+/*
+ * Get transmit counters of the TCP/IP transport.
+ *
+ * @param stats: output
+ */
+void gb_tcpip_tx_stats_get(struct gb_tcpip_tx_stats *stats);
+
+#endif // _GREYBUS_TRANSPORT_TCPIP_H_
@@ -0,0 +1,674 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Greybus over UDP, one message per datagram.
+ *
+ * Every datagram starts with a struct gb_udp_hdr. Requests which expect a response, and responses,
+ * are sent with GB_UDP_FLAG_RELIABLE. The receiver acknowledges each of them with a GB_UDP_FLAG_ACK
+ * datagram carrying the same sequence number, and the sender retransmits only the datagrams which
+ * are not acknowledged in time. Unidirectional requests, such as GPIO interrupt events and UART
+ * receive data, are sent once, since a late copy is worth less than the next one. Only
+ * acknowledgements from the peer are accepted, and a new session of the peer restarts the
+ * detection of duplicates.
+ */
+
+#include <greybus/greybus.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/dns_sd.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/byteorder.h>
+#include <greybus/greybus_messages.h>
+#include "../greybus_internal.h"
+#include "../greybus_trace.h"
+#include "../greybus_transport.h"
+#include "udp.h"
+
+LOG_MODULE_REGISTER(greybus_transport_udp, CONFIG_GREYBUS_LOG_LEVEL);
+
+#define GB_TRANSPORT_UDP_PORT    4242
+
+#define GB_UDP_RX_STACK_SIZE     1024
+#define GB_UDP_RX_STACK_PRIORITY 6
+#define GB_UDP_TX_STACK_SIZE     1024
+#define GB_UDP_TX_STACK_PRIORITY 6
+/* Reliable sequence numbers remembered by the receiver to drop duplicates */
+#define GB_UDP_RX_WINDOW         32
+
+DNS_SD_REGISTER_UDP_SERVICE(gb_udp_service_advertisement, CONFIG_NET_HOSTNAME, "_greybus", "local",
+			    DNS_SD_EMPTY_TXT, GB_TRANSPORT_UDP_PORT);
+
+K_THREAD_STACK_DEFINE(gb_udp_rx_stack, GB_UDP_RX_STACK_SIZE);
+K_THREAD_STACK_DEFINE(gb_udp_tx_stack, GB_UDP_TX_STACK_SIZE);
+
+/*
+ * struct gb_udp_tx_item: Message waiting to be transmitted
+ *
+ * @msg: greybus message held by reference
+ * @cport: cport of the message
+ */
+struct gb_udp_tx_item {
+	struct gb_message *msg;
+	uint16_t cport;
+};
+
+K_MSGQ_DEFINE(gb_udp_tx_queue, sizeof(struct gb_udp_tx_item), CONFIG_GREYBUS_UDP_TX_QUEUE_DEPTH,
+	      sizeof(void *));
+
+/*
+ * struct gb_udp_pending: Reliable message waiting to be acknowledged
+ *
+ * @msg: greybus message held by reference. NULL if the slot is free.
+ * @deadline: time of the next retransmission
+ * @seq: sequence number of the datagram
+ * @cport: cport of the message
+ * @tries: number of transmissions so far
+ * @sending: true while the tx thread transmits the message outside of the lock
+ * @acked: true if the acknowledgement arrived while sending
+ */
+struct gb_udp_pending {
+	struct gb_message *msg;
+	k_timepoint_t deadline;
+	uint16_t seq;
+	uint16_t cport;
+	uint8_t tries;
+	bool sending;
+	bool acked;
+};
+
+/*
+ * struct gb_udp_ctx: Transport Context
+ *
+ * @rx_thread: thread receiving datagrams
+ * @tx_thread: thread which transmits and retransmits messages
+ * @sock: UDP socket
+ * @lock: protects peer and pending
+ * @peer: address of the AP, learned from the last valid datagram
+ * @peer_len: length of peer. 0 until a datagram is received.
+ * @window: number of free entries in pending
+ * @pending: reliable messages waiting to be acknowledged
+ * @tx_seq: sequence number of the next datagram
+ * @tx_session: session of the datagrams sent, picked at random on init
+ * @rx_session: session of the peer
+ * @rx_synced: true once a reliable datagram was received from the peer
+ * @rx_seq_max: highest reliable sequence number received
+ * @rx_seen: reliable sequence numbers received, bit n being rx_seq_max - n
+ * @stats: counters
+ * @rx_buf: datagram being received
+ */
+struct gb_udp_ctx {
+	struct k_thread rx_thread;
+	struct k_thread tx_thread;
+	int sock;
+	struct k_spinlock lock;
+	struct sockaddr peer;
+	socklen_t peer_len;
+	struct k_sem window;
+	struct gb_udp_pending pending[CONFIG_GREYBUS_UDP_TX_WINDOW];
+	uint16_t tx_seq;
+	uint8_t tx_session;
+	uint8_t rx_session;
+	bool rx_synced;
+	uint16_t rx_seq_max;
+	uint32_t rx_seen;
+	struct gb_udp_stats stats;
+	uint8_t rx_buf[CONFIG_GREYBUS_UDP_RX_BUF_SIZE];
+};
+
+static struct gb_udp_ctx ctx;
+
+/* Requests which expect a response, and responses, are retransmitted until acknowledged */
+static bool gb_udp_is_reliable(const struct gb_operation_msg_hdr *hdr)
+{
+	return gb_hdr_is_response(hdr) || hdr->operation_id != 0;
+}
+
+/*
+ * Helper to send a datagram to the peer
+ *
+ * @param msg: message. NULL for an acknowledgement.
+ */
+static int gb_udp_xmit(struct gb_udp_ctx *ctx, uint16_t seq, uint8_t flags, uint16_t cport,
+		       const struct gb_message *msg)
+{
+	k_spinlock_key_t key;
+	struct sockaddr peer;
+	socklen_t peer_len;
+	struct gb_udp_hdr hdr = {
+		.seq = sys_cpu_to_le16(seq),
+		.flags = flags,
+		.session = ctx->tx_session,
+		.cport = sys_cpu_to_le16(cport),
+	};
+	struct iovec iov[2] = {
+		{
+			.iov_base = &hdr,
+			.iov_len = sizeof(hdr),
+		},
+	};
+	struct msghdr dgram = {
+		.msg_name = &peer,
+		.msg_iov = iov,
+		.msg_iovlen = 1,
+	};
+
+	key = k_spin_lock(&ctx->lock);
+	peer = ctx->peer;
+	peer_len = ctx->peer_len;
+	k_spin_unlock(&ctx->lock, key);
+
+	/* Nowhere to send to until the AP sends something */
+	if (peer_len == 0) {
+		return -ENOTCONN;
+	}
+	dgram.msg_namelen = peer_len;
+
+	if (msg) {
+		iov[1].iov_base = (void *)msg;
+		iov[1].iov_len = sys_le16_to_cpu(msg->header.size);
+		dgram.msg_iovlen = 2;
+	}
+
+	if (zsock_sendmsg(ctx->sock, &dgram, 0) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+/*
+ * Helper to release a pending slot
+ *
+ * @return message of the slot, which must be dropped with gb_message_put after unlocking.
+ */
+static struct gb_message *gb_udp_pending_free(struct gb_udp_pending *p)
+{
+	struct gb_message *msg = p->msg;
+
+	p->msg = NULL;
+	p->sending = false;
+	p->acked = false;
+
+	return msg;
+}
+
+static void gb_udp_pending_put(struct gb_udp_ctx *ctx, struct gb_message *msg)
+{
+	if (msg) {
+		gb_message_put(msg);
+		k_sem_give(&ctx->window);
+	}
+}
+
+/*
+ * Helper to transmit a pending message. The lock is not held while sending, so an
+ * acknowledgement arriving meanwhile is only recorded, and handled here afterwards.
+ */
+static void gb_udp_pending_send(struct gb_udp_ctx *ctx, struct gb_udp_pending *p)
+{
+	int ret;
+	k_spinlock_key_t key;
+	struct gb_message *done = NULL;
+
+	ret = gb_udp_xmit(ctx, p->seq, GB_UDP_FLAG_RELIABLE, p->cport, p->msg);
+	if (ret < 0) {
+		LOG_DBG("Failed to send datagram %u: %d", p->seq, ret);
+	}
+
+	key = k_spin_lock(&ctx->lock);
+	p->tries++;
+	p->deadline = sys_timepoint_calc(K_MSEC(CONFIG_GREYBUS_UDP_RETRANSMIT_TIMEOUT_MS));
+	p->sending = false;
+	if (p->acked) {
+		done = gb_udp_pending_free(p);
+	}
+	k_spin_unlock(&ctx->lock, key);
+
+	gb_udp_pending_put(ctx, done);
+}
+
+/*
+ * Helper to retransmit every pending message whose deadline passed, and give up on the ones
+ * retransmitted too often
+ *
+ * @return time until the next deadline
+ */
+static k_timeout_t gb_udp_retransmit(struct gb_udp_ctx *ctx)
+{
+	size_t i;
+	k_spinlock_key_t key;
+	struct gb_message *done;
+	struct gb_udp_pending *p;
+	k_timepoint_t next = sys_timepoint_calc(K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(ctx->pending); i++) {
+		p = &ctx->pending[i];
+		done = NULL;
+
+		key = k_spin_lock(&ctx->lock);
+		if (!p->msg || !sys_timepoint_expired(p->deadline)) {
+			if (p->msg && sys_timepoint_cmp(p->deadline, next) < 0) {
+				next = p->deadline;
+			}
+			k_spin_unlock(&ctx->lock, key);
+			continue;
+		}
+
+		if (p->tries > CONFIG_GREYBUS_UDP_RETRANSMIT_COUNT) {
+			LOG_WRN("Datagram %u on cport %u not acknowledged", p->seq, p->cport);
+			ctx->stats.tx_timeouts++;
+			done = gb_udp_pending_free(p);
+			k_spin_unlock(&ctx->lock, key);
+			gb_udp_pending_put(ctx, done);
+			continue;
+		}
+
+		p->sending = true;
+		k_spin_unlock(&ctx->lock, key);
+
+		ctx->stats.tx_retransmits++;
+		gb_udp_pending_send(ctx, p);
+
+		if (sys_timepoint_cmp(p->deadline, next) < 0) {
+			next = p->deadline;
+		}
+	}
+
+	return sys_timepoint_timeout(next);
+}
+
+static void gb_udp_tx(struct gb_udp_ctx *ctx, struct gb_udp_tx_item *item)
+{
+	int ret;
+	size_t i;
+	k_spinlock_key_t key;
+	struct gb_udp_pending *p = NULL;
+	const uint16_t seq = ctx->tx_seq++;
+
+	gb_trace(GB_TRACE_TRANSPORT_TX, item->cport, &item->msg->header);
+	ctx->stats.tx_datagrams++;
+
+	if (!gb_udp_is_reliable(&item->msg->header)) {
+		ret = gb_udp_xmit(ctx, seq, 0, item->cport, item->msg);
+		if (ret < 0) {
+			LOG_DBG("Failed to send datagram %u: %d", seq, ret);
+		}
+		gb_message_put(item->msg);
+		return;
+	}
+
+	/* Keep retransmitting while waiting for a free slot */
+	while (k_sem_take(&ctx->window, gb_udp_retransmit(ctx)) < 0) {
+	}
+
+	key = k_spin_lock(&ctx->lock);
+	for (i = 0; i < ARRAY_SIZE(ctx->pending); i++) {
+		if (!ctx->pending[i].msg) {
+			p = &ctx->pending[i];
+			break;
+		}
+	}
+
+	/* Taking the window guarantees a free slot */
+	__ASSERT_NO_MSG(p);
+	p->msg = item->msg;
+	p->seq = seq;
+	p->cport = item->cport;
+	p->tries = 0;
+	p->sending = true;
+	k_spin_unlock(&ctx->lock, key);
+
+	gb_udp_pending_send(ctx, p);
+}
+
+/*
+ * Hander function for tx thread
+ */
+static void gb_udp_tx_thread_handler(void *p1, void *p2, void *p3)
+{
+	struct gb_udp_tx_item item;
+
+	while (true) {
+		if (k_msgq_get(&gb_udp_tx_queue, &item, gb_udp_retransmit(&ctx)) == 0) {
+			gb_udp_tx(&ctx, &item);
+		}
+	}
+}
+
+/* Called with lock held */
+static bool gb_udp_is_peer(const struct gb_udp_ctx *ctx, const struct sockaddr *addr,
+			   socklen_t addr_len)
+{
+	return addr_len == ctx->peer_len && memcmp(addr, &ctx->peer, addr_len) == 0;
+}
+
+static void gb_udp_rx_ack(struct gb_udp_ctx *ctx, uint16_t seq, const struct sockaddr *addr,
+			  socklen_t addr_len)
+{
+	size_t i;
+	k_spinlock_key_t key;
+	struct gb_message *done = NULL;
+
+	key = k_spin_lock(&ctx->lock);
+
+	/* Any other host could cancel retransmissions otherwise */
+	if (!gb_udp_is_peer(ctx, addr, addr_len)) {
+		k_spin_unlock(&ctx->lock, key);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctx->pending); i++) {
+		if (!ctx->pending[i].msg || ctx->pending[i].seq != seq) {
+			continue;
+		}
+
+		if (ctx->pending[i].sending) {
+			ctx->pending[i].acked = true;
+		} else {
+			done = gb_udp_pending_free(&ctx->pending[i]);
+		}
+		break;
+	}
+	k_spin_unlock(&ctx->lock, key);
+
+	gb_udp_pending_put(ctx, done);
+}
+
+/*
+ * Helper to remember the sender of a valid datagram as the peer. Sequence numbers of a new peer,
+ * or of a new session of the peer, start over.
+ */
+static void gb_udp_peer_set(struct gb_udp_ctx *ctx, const struct sockaddr *addr,
+			    socklen_t addr_len, uint8_t session)
+{
+	k_spinlock_key_t key = k_spin_lock(&ctx->lock);
+
+	if (!gb_udp_is_peer(ctx, addr, addr_len) || session != ctx->rx_session) {
+		memcpy(&ctx->peer, addr, addr_len);
+		ctx->peer_len = addr_len;
+		ctx->rx_session = session;
+		ctx->rx_synced = false;
+	}
+
+	k_spin_unlock(&ctx->lock, key);
+}
+
+/* @return true if the reliable datagram was received before */
+static bool gb_udp_rx_seen(const struct gb_udp_ctx *ctx, uint16_t seq)
+{
+	const int16_t diff = seq - ctx->rx_seq_max;
+
+	if (!ctx->rx_synced || diff > 0 || -diff >= GB_UDP_RX_WINDOW) {
+		return false;
+	}
+
+	return ctx->rx_seen & BIT(-diff);
+}
+
+static void gb_udp_rx_mark(struct gb_udp_ctx *ctx, uint16_t seq)
+{
+	const int16_t diff = seq - ctx->rx_seq_max;
+
+	/* First datagram, or too far from the last one, e.g. after the peer restarted */
+	if (!ctx->rx_synced || diff >= GB_UDP_RX_WINDOW || -diff >= GB_UDP_RX_WINDOW) {
+		ctx->rx_synced = true;
+		ctx->rx_seq_max = seq;
+		ctx->rx_seen = BIT(0);
+	} else if (diff > 0) {
+		ctx->rx_seq_max = seq;
+		ctx->rx_seen = (ctx->rx_seen << diff) | BIT(0);
+	} else {
+		ctx->rx_seen |= BIT(-diff);
+	}
+}
+
+static void gb_udp_rx_datagram(struct gb_udp_ctx *ctx, size_t len, const struct sockaddr *addr,
+			       socklen_t addr_len)
+{
+	int ret;
+	uint16_t seq, cport;
+	bool reliable;
+	struct gb_message *msg;
+	struct gb_udp_hdr hdr;
+	struct gb_operation_msg_hdr msg_hdr;
+
+	if (len < sizeof(hdr)) {
+		ctx->stats.rx_errors++;
+		return;
+	}
+
+	memcpy(&hdr, ctx->rx_buf, sizeof(hdr));
+	seq = sys_le16_to_cpu(hdr.seq);
+	cport = sys_le16_to_cpu(hdr.cport);
+
+	if (hdr.flags & GB_UDP_FLAG_ACK) {
+		return gb_udp_rx_ack(ctx, seq, addr, addr_len);
+	}
+
+	/* Exactly one message per datagram */
+	if (len - sizeof(hdr) < sizeof(msg_hdr)) {
+		ctx->stats.rx_errors++;
+		return;
+	}
+
+	memcpy(&msg_hdr, ctx->rx_buf + sizeof(hdr), sizeof(msg_hdr));
+	if (sys_le16_to_cpu(msg_hdr.size) != len - sizeof(hdr)) {
+		ctx->stats.rx_errors++;
+		return;
+	}
+
+	gb_udp_peer_set(ctx, addr, addr_len, hdr.session);
+
+	/* The acknowledgement was lost, send it again */
+	reliable = hdr.flags & GB_UDP_FLAG_RELIABLE;
+	if (reliable && gb_udp_rx_seen(ctx, seq)) {
+		ctx->stats.rx_duplicates++;
+		gb_udp_xmit(ctx, seq, GB_UDP_FLAG_ACK, cport, NULL);
+		return;
+	}
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+	if (gb_hdr_payload_len(&msg_hdr) > CONFIG_GREYBUS_MAX_PAYLOAD_SIZE) {
+		ctx->stats.rx_errors++;
+		return;
+	}
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
+	/* Not acknowledged, so the peer retransmits it once memory is available */
+	msg = gb_message_alloc(gb_hdr_payload_len(&msg_hdr), msg_hdr.type, msg_hdr.operation_id,
+			       msg_hdr.result);
+	if (!msg) {
+		ctx->stats.rx_dropped++;
+		return;
+	}
+	memcpy(msg->payload, ctx->rx_buf + sizeof(hdr) + sizeof(msg_hdr),
+	       gb_message_payload_len(msg));
+
+	/* Acknowledge before handling, so that a slow handler does not cause a retransmission */
+	if (reliable) {
+		gb_udp_rx_mark(ctx, seq);
+		gb_udp_xmit(ctx, seq, GB_UDP_FLAG_ACK, cport, NULL);
+	}
+
+	gb_trace(GB_TRACE_TRANSPORT_RX, cport, &msg->header);
+
+	ret = greybus_rx_handler(cport, msg);
+	if (ret < 0) {
+		LOG_ERR("Failed to receive greybus message");
+		gb_message_dealloc(msg);
+		return;
+	}
+
+	ctx->stats.rx_datagrams++;
+}
+
+/*
+ * Hander function for rx thread
+ */
+static void gb_udp_rx_thread_handler(void *p1, void *p2, void *p3)
+{
+	int ret;
+	struct sockaddr addr;
+	socklen_t addr_len;
+
+	while (true) {
+		addr_len = sizeof(addr);
+		ret = zsock_recvfrom(ctx.sock, ctx.rx_buf, sizeof(ctx.rx_buf), 0, &addr, &addr_len);
+		if (ret < 0) {
+			LOG_ERR("Failed to receive datagram (%d)", errno);
+			continue;
+		}
+
+		gb_udp_rx_datagram(&ctx, ret, &addr, addr_len);
+	}
+}
+
+static int gb_udp_listen_start(uint16_t cport)
+{
+	return 0;
+}
+
+static int gb_udp_listen_stop(uint16_t cport)
+{
+	return 0;
+}
+
+/*
+ * Queue a message for the tx thread by reference. This never blocks on the socket, so it is safe
+ * to call from any context.
+ */
+static int gb_udp_send_ref(uint16_t cport, struct gb_message *msg)
+{
+	int ret;
+	const struct gb_udp_tx_item item = {
+		.msg = msg,
+		.cport = cport,
+	};
+
+	if (msg->header.result) {
+		LOG_INF("CPort %u, Type: %u, Result: %u, Id: %u", cport, msg->header.type,
+			msg->header.result, msg->header.operation_id);
+	}
+
+	ret = k_msgq_put(&gb_udp_tx_queue, &item, k_is_in_isr() ? K_NO_WAIT : K_FOREVER);
+	if (ret < 0) {
+		LOG_ERR("Transmit queue full");
+		gb_message_put(msg);
+	}
+
+	return ret;
+}
+
+/* In interrupts, the copy fails instead of waiting when memory is exhausted */
+static int gb_udp_send(uint16_t cport, const struct gb_message *msg)
+{
+	struct gb_message *copy = gb_message_copy(msg);
+
+	if (!copy) {
+		return -ENOMEM;
+	}
+
+	return gb_udp_send_ref(cport, copy);
+}
+
+void gb_udp_stats_get(struct gb_udp_stats *stats)
+{
+	*stats = ctx.stats;
+}
+
+static int gb_udp_socket(void)
+{
+	int sock, ret;
+	struct sockaddr sa;
+	socklen_t sa_len;
+
+	memset(&sa, 0, sizeof(sa));
+	if (IS_ENABLED(CONFIG_NET_IPV6)) {
+		net_sin6(&sa)->sin6_family = AF_INET6;
+		net_sin6(&sa)->sin6_addr = in6addr_any;
+		net_sin6(&sa)->sin6_port = htons(GB_TRANSPORT_UDP_PORT);
+		sa_len = sizeof(struct sockaddr_in6);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4)) {
+		net_sin(&sa)->sin_family = AF_INET;
+		net_sin(&sa)->sin_addr.s_addr = INADDR_ANY;
+		net_sin(&sa)->sin_port = htons(GB_TRANSPORT_UDP_PORT);
+		sa_len = sizeof(struct sockaddr_in);
+	} else {
+		LOG_ERR("Neither IPv6 nor IPv4 is available");
+		return -EINVAL;
+	}
+
+	sock = zsock_socket(sa.sa_family, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0) {
+		LOG_ERR("socket: %d", errno);
+		return -errno;
+	}
+
+	ret = zsock_bind(sock, &sa, sa_len);
+	if (ret < 0) {
+		LOG_ERR("bind: %d", errno);
+		ret = -errno;
+		zsock_close(sock);
+		return ret;
+	}
+
+	LOG_INF("Greybus socket opened at UDP port %u", GB_TRANSPORT_UDP_PORT);
+
+	return sock;
+}
+
+static int gb_udp_init(void)
+{
+	ctx.sock = gb_udp_socket();
+	if (ctx.sock < 0) {
+		return ctx.sock;
+	}
+
+	ctx.peer_len = 0;
+	ctx.rx_synced = false;
+	/* Lets the peer tell a restart from retransmissions, unless the same session comes up */
+	ctx.tx_session = sys_rand8_get();
+	k_sem_init(&ctx.window, ARRAY_SIZE(ctx.pending), ARRAY_SIZE(ctx.pending));
+
+	k_thread_create(&ctx.tx_thread, gb_udp_tx_stack, K_THREAD_STACK_SIZEOF(gb_udp_tx_stack),
+			gb_udp_tx_thread_handler, NULL, NULL, NULL, GB_UDP_TX_STACK_PRIORITY, 0,
+			K_NO_WAIT);
+
+	k_thread_create(&ctx.rx_thread, gb_udp_rx_stack, K_THREAD_STACK_SIZEOF(gb_udp_rx_stack),
+			gb_udp_rx_thread_handler, NULL, NULL, NULL, GB_UDP_RX_STACK_PRIORITY, 0,
+			K_NO_WAIT);
+
+	return 0;
+}
+
+static void gb_udp_exit(void)
+{
+	size_t i;
+	struct gb_udp_tx_item item;
+
+	k_thread_abort(&ctx.rx_thread);
+	k_thread_abort(&ctx.tx_thread);
+
+	while (k_msgq_get(&gb_udp_tx_queue, &item, K_NO_WAIT) == 0) {
+		gb_message_put(item.msg);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctx.pending); i++) {
+		gb_message_put(gb_udp_pending_free(&ctx.pending[i]));
+	}
+
+	zsock_close(ctx.sock);
+}
+
+GB_TRANSPORT_BACKEND_DEFINE(udp) = {
+	.init = gb_udp_init,
+	.exit = gb_udp_exit,
+	.listen = gb_udp_listen_start,
+	.stop_listening = gb_udp_listen_stop,
+	.send = gb_udp_send,
+	.send_ref = gb_udp_send_ref,
+};
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GREYBUS_TRANSPORT_UDP_H_
+#define _GREYBUS_TRANSPORT_UDP_H_
+
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/types.h>
+
+/* Datagram is an acknowledgement of the datagram with sequence number seq, without a message */
+#define GB_UDP_FLAG_ACK      BIT(0)
+/* Datagram must be acknowledged, and is retransmitted until it is */
+#define GB_UDP_FLAG_RELIABLE BIT(1)
+
+/*
+ * struct gb_udp_hdr: Start of every datagram, followed by one greybus message
+ *
+ * @seq: sequence number, incremented for every datagram with a message sent in a direction
+ * @flags: GB_UDP_FLAG_*
+ * @session: picked by the sender when it starts. Sequence numbers of a direction start over with
+ *	     a new session, so datagrams of a restarted sender are not taken for duplicates.
+ * @cport: cport of the message
+ */
+struct gb_udp_hdr {
+	__le16 seq;
+	uint8_t flags;
+	uint8_t session;
+	__le16 cport;
+} __packed;
+
+/*
+ * struct gb_udp_stats: UDP transport counters
+ *
+ * @rx_datagrams: number of messages received and handed to greybus
+ * @rx_duplicates: number of retransmitted messages which were already received
+ * @rx_errors: number of malformed datagrams
+ * @rx_dropped: number of valid messages dropped for lack of memory
+ * @tx_datagrams: number of messages transmitted, not counting retransmissions
+ * @tx_retransmits: number of retransmissions
+ * @tx_timeouts: number of reliable messages never acknowledged
+ */
+struct gb_udp_stats {
+	uint32_t rx_datagrams;
+	uint32_t rx_duplicates;
+	uint32_t rx_errors;
+	uint32_t rx_dropped;
+	uint32_t tx_datagrams;
+	uint32_t tx_retransmits;
+	uint32_t tx_timeouts;
+};
+
+/*
+ * Get counters of the UDP transport.
+ *
+ * @param stats: output
+ */
+void gb_udp_stats_get(struct gb_udp_stats *stats);
+
+#endif // _GREYBUS_TRANSPORT_UDP_H_
@@ -37,6 +37,11 @@ LOG_MODULE_REGISTER(greybus_uart, CONFIG_GREYBUS_LOG_LEVEL);
 /* Reserved buffer for rx data. */
 #define MAX_RX_BUF_SIZE 64
 
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+BUILD_ASSERT(MAX_RX_BUF_SIZE <= CONFIG_GREYBUS_MAX_PAYLOAD_SIZE,
+	     "UART receive buffer does not fit in CONFIG_GREYBUS_MAX_PAYLOAD_SIZE");
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
+
 /* The id of error in protocol operating. */
 #define GB_UART_EVENT_PROTOCOL_ERROR 1
 #define GB_UART_EVENT_DEVICE_ERROR   2
@@ -51,8 +56,7 @@ static void gb_uart_receive_credits(uint16_t cport, uint16_t count)
 
 	req_data->count = sys_cpu_to_le16(count);
 
-	gb_transport_message_send(msg, cport);
-	gb_message_dealloc(msg);
+	gb_transport_message_send_consume(msg, cport);
 }
 
 /**
@@ -219,7 +223,8 @@ static void uart_irq_cb(const struct device *dev, void *user_data)
 		ret + sizeof(struct gb_message) + sizeof(struct gb_uart_recv_data_request);
 
 	if (ret) {
-		gb_transport_message_send(req, cport);
+		gb_transport_message_send_consume(req, cport);
+		return;
 	}
 
 free_msg:
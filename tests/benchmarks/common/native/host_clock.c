@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2026 Ayush Singh BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Built for the host side of native_sim. Provides wall clock time to the benchmarks.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+uint64_t gb_bench_host_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Frame decoder throughput benchmark. Encoded frames are pushed to the decoder in chunks the size
+ * of a typical DMA or socket read, and every decoded message is popped and freed, the way a byte
+ * stream transport does.
+ *
+ * Results are printed as one JSON object per line, prefixed with "GB_BENCH ", so that they can be
+ * collected from the console output and compared between releases.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <greybus/greybus_messages.h>
+#include "greybus_frame.h"
+
+#define BENCH_CPORT  1
+#define ITERATIONS   200
+#define CHUNK_SIZE   64
+/* Encoded frames, decoded over and over */
+#define STREAM_SIZE  8192
+/* Largest greybus message on the wire */
+#define GB_BENCH_MTU 2048
+
+#ifdef CONFIG_ARCH_POSIX
+uint64_t gb_bench_host_time_ns(void);
+
+static uint64_t now_ns(void)
+{
+	return gb_bench_host_time_ns();
+}
+#else
+static uint64_t now_ns(void)
+{
+	return k_cyc_to_ns_floor64(k_cycle_get_64());
+}
+#endif // CONFIG_ARCH_POSIX
+
+static uint8_t stream[STREAM_SIZE];
+
+/*
+ * Fill the stream with as many frames as fit. Payload bytes count up, so that HDLC frames carry
+ * the occasional byte which needs escaping.
+ *
+ * @return length of the encoded frames.
+ */
+static size_t encode(enum gb_frame_format format, size_t payload_len, size_t *frames)
+{
+	size_t i, frame_len, len = 0;
+	struct gb_frame_encoder enc;
+	/* Every byte escaped, plus flags and frame check sequence */
+	static uint8_t frame[GB_BENCH_MTU * 2 + 8];
+	struct gb_message *msg = gb_message_request_alloc(payload_len, 1, false);
+
+	*frames = 0;
+	if (!msg) {
+		return 0;
+	}
+
+	for (i = 0; i < payload_len; i++) {
+		msg->payload[i] = i;
+	}
+
+	gb_frame_encoder_init(&enc, format, BENCH_CPORT, msg);
+	frame_len = 0;
+	while ((i = gb_frame_encoder_pull(&enc, frame + frame_len, sizeof(frame) - frame_len))) {
+		frame_len += i;
+	}
+
+	while (len + frame_len <= sizeof(stream)) {
+		memcpy(stream + len, frame, frame_len);
+		len += frame_len;
+		(*frames)++;
+	}
+
+	gb_message_dealloc(msg);
+
+	return len;
+}
+
+static int decode(struct gb_frame_decoder *dec, size_t len, size_t frames)
+{
+	int ret;
+	size_t pos = 0, decoded = 0;
+	uint16_t cport;
+	struct gb_message *msg;
+
+	while (pos < len) {
+		ret = gb_frame_decoder_push(dec, stream + pos, MIN(CHUNK_SIZE, len - pos));
+		if (ret < 0) {
+			return ret;
+		}
+		pos += ret;
+
+		msg = gb_frame_decoder_pop(dec, &cport);
+		if (msg) {
+			gb_message_dealloc(msg);
+			decoded++;
+		}
+	}
+
+	return decoded == frames ? 0 : -EIO;
+}
+
+static int run(const char *format_name, enum gb_frame_format format, size_t payload_len)
+{
+	int ret;
+	size_t i, len, frames;
+	uint64_t start, elapsed_ns, kbytes_per_s, frames_per_s;
+	struct gb_frame_decoder dec;
+#ifndef CONFIG_ARCH_POSIX
+	uint64_t start_cyc, cycles;
+#endif // CONFIG_ARCH_POSIX
+
+	len = encode(format, payload_len, &frames);
+	if (frames == 0) {
+		return -ENOMEM;
+	}
+
+	gb_frame_decoder_init(&dec, format);
+
+	/* Warm up, and check that every frame is decoded */
+	ret = decode(&dec, len, frames);
+	if (ret < 0) {
+		return ret;
+	}
+
+	start = now_ns();
+#ifndef CONFIG_ARCH_POSIX
+	start_cyc = k_cycle_get_64();
+#endif // CONFIG_ARCH_POSIX
+	for (i = 0; i < ITERATIONS && ret == 0; i++) {
+		ret = decode(&dec, len, frames);
+	}
+#ifndef CONFIG_ARCH_POSIX
+	cycles = MAX(k_cycle_get_64() - start_cyc, 1);
+#endif // CONFIG_ARCH_POSIX
+	elapsed_ns = MAX(now_ns() - start, 1);
+
+	gb_frame_decoder_reset(&dec);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Throughput counts bytes on the wire, including framing overhead */
+	kbytes_per_s = (uint64_t)ITERATIONS * len * NSEC_PER_SEC / elapsed_ns / 1024;
+	frames_per_s = (uint64_t)ITERATIONS * frames * NSEC_PER_SEC / elapsed_ns;
+
+#ifdef CONFIG_ARCH_POSIX
+	printk("GB_BENCH {\"op\":\"decode\",\"format\":\"%s\",\"payload\":%zu,\"bytes\":%zu,"
+	       "\"frames_per_s\":%llu,\"kbytes_per_s\":%llu}\n",
+	       format_name, payload_len, len, frames_per_s, kbytes_per_s);
+#else
+	/* Cycles are only counted on hardware, simulated time does not advance */
+	printk("GB_BENCH {\"op\":\"decode\",\"format\":\"%s\",\"payload\":%zu,\"bytes\":%zu,"
+	       "\"frames_per_s\":%llu,\"kbytes_per_s\":%llu,\"bytes_per_kcycle\":%llu}\n",
+	       format_name, payload_len, len, frames_per_s, kbytes_per_s,
+	       (uint64_t)ITERATIONS * len * 1000 / cycles);
+#endif // CONFIG_ARCH_POSIX
+
+	return 0;
+}
+
+int main(void)
+{
+	int ret;
+	size_t i;
+	static const size_t sizes[] = {
+		0, 16, 64, 256, 1024, GB_BENCH_MTU - sizeof(struct gb_operation_msg_hdr),
+	};
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		ret = run("stream", GB_FRAME_STREAM, sizes[i]);
+		if (ret < 0) {
+			printk("GB_BENCH FAILED stream %zu: %d\n", sizes[i], ret);
+			return ret;
+		}
+
+		ret = run("hdlc", GB_FRAME_HDLC, sizes[i]);
+		if (ret < 0) {
+			printk("GB_BENCH FAILED hdlc %zu: %d\n", sizes[i], ret);
+			return ret;
+		}
+	}
+
+	printk("GB_BENCH DONE\n");
+
+	return 0;
+}
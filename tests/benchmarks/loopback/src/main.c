@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Loopback round trip benchmark. Every operation is fed to greybus_rx_handler and its response is
+ * read back from the dummy transport before the next one is sent.
+ *
+ * Results are printed as one JSON object per line, prefixed with "GB_BENCH ", so that they can be
+ * collected from the console output and compared between releases.
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <greybus/greybus.h>
+#include <greybus/greybus_messages.h>
+#include <greybus/greybus_protocols.h>
+
+#define LOOPBACK_CPORT 1
+#define ITERATIONS     2000
+#define WARMUP         50
+
+/* Largest greybus message sent on the wire */
+#define GB_BENCH_MTU 2048
+#define GB_BENCH_TRANSFER_MAX                                                                      \
+	(GB_BENCH_MTU - sizeof(struct gb_operation_msg_hdr) -                                      \
+	 sizeof(struct gb_loopback_transfer_request))
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+#ifdef CONFIG_ARCH_POSIX
+uint64_t gb_bench_host_time_ns(void);
+
+static uint64_t now_ns(void)
+{
+	return gb_bench_host_time_ns();
+}
+#else
+static uint64_t now_ns(void)
+{
+	return k_cyc_to_ns_floor64(k_cycle_get_64());
+}
+#endif // CONFIG_ARCH_POSIX
+
+static uint32_t samples[ITERATIONS];
+
+static int cmp_u32(const void *a, const void *b)
+{
+	const uint32_t x = *(const uint32_t *)a;
+	const uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Nearest rank percentile of sorted samples, in per mille */
+static uint32_t percentile(size_t per_mille)
+{
+	size_t rank = DIV_ROUND_UP(per_mille * ARRAY_SIZE(samples), 1000);
+
+	return samples[MAX(rank, 1) - 1];
+}
+
+static struct gb_message *request_alloc(uint8_t type, size_t len)
+{
+	struct gb_message *req;
+	struct gb_loopback_transfer_request *req_data;
+
+	if (type == GB_LOOPBACK_TYPE_PING) {
+		return gb_message_request_alloc(0, type, false);
+	}
+
+	req = gb_message_request_alloc(sizeof(*req_data) + len, type, false);
+	if (!req) {
+		return NULL;
+	}
+
+	req_data = (struct gb_loopback_transfer_request *)req->payload;
+	req_data->len = sys_cpu_to_le32(len);
+	req_data->reserved0 = 0;
+	req_data->reserved1 = 0;
+	memset(req_data->data, 0xa5, len);
+
+	return req;
+}
+
+static int round_trip(uint8_t type, size_t len, uint32_t *elapsed_ns)
+{
+	uint64_t start;
+	struct gb_msg_with_cport resp;
+	struct gb_message *req = request_alloc(type, len);
+
+	if (!req) {
+		return -ENOMEM;
+	}
+
+	start = now_ns();
+	greybus_rx_handler(LOOPBACK_CPORT, req);
+	resp = gb_transport_get_message();
+	*elapsed_ns = now_ns() - start;
+
+	if (!gb_message_is_success(resp.msg) || gb_message_type(resp.msg) != GB_RESPONSE(type)) {
+		gb_message_dealloc(resp.msg);
+		return -EIO;
+	}
+
+	gb_message_dealloc(resp.msg);
+	return 0;
+}
+
+static int run(const char *op, uint8_t type, size_t len)
+{
+	int ret;
+	size_t i;
+	uint32_t ignored;
+	uint64_t total_ns = 0;
+	uint64_t msgs_per_s, kbytes_per_s;
+
+	for (i = 0; i < WARMUP; i++) {
+		ret = round_trip(type, len, &ignored);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(samples); i++) {
+		ret = round_trip(type, len, &samples[i]);
+		if (ret < 0) {
+			return ret;
+		}
+		total_ns += samples[i];
+	}
+
+	qsort(samples, ARRAY_SIZE(samples), sizeof(samples[0]), cmp_u32);
+
+	total_ns = MAX(total_ns, 1);
+	msgs_per_s = (uint64_t)ARRAY_SIZE(samples) * NSEC_PER_SEC / total_ns;
+	/* Payload is counted once per round trip */
+	kbytes_per_s = (uint64_t)ARRAY_SIZE(samples) * len * NSEC_PER_SEC / total_ns / 1024;
+
+	printk("GB_BENCH {\"op\":\"%s\",\"payload\":%zu,\"msgs\":%zu,\"msgs_per_s\":%llu,"
+	       "\"kbytes_per_s\":%llu,\"p50_ns\":%u,\"p99_ns\":%u,\"p999_ns\":%u}\n",
+	       op, len, ARRAY_SIZE(samples), msgs_per_s, kbytes_per_s, percentile(500),
+	       percentile(990), percentile(999));
+
+	return 0;
+}
+
+int main(void)
+{
+	int ret;
+	size_t i;
+	static const size_t sizes[] = {0, 16, 64, 256, 1024, GB_BENCH_TRANSFER_MAX};
+
+	ret = run("ping", GB_LOOPBACK_TYPE_PING, 0);
+	if (ret < 0) {
+		printk("GB_BENCH FAILED ping: %d\n", ret);
+		return ret;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		ret = run("transfer", GB_LOOPBACK_TYPE_TRANSFER, sizes[i]);
+		if (ret < 0) {
+			printk("GB_BENCH FAILED transfer %zu: %d\n", sizes[i], ret);
+			return ret;
+		}
+	}
+
+	printk("GB_BENCH DONE\n");
+
+	return 0;
+}
@@ -0,0 +1,861 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host side traffic generator for the greybus TCP/IP transport.
+ *
+ * Connects to a greybus node the way an AP would, enables the cports under test and then keeps a
+ * fixed number of operations in flight on the connection, drawn from a weighted mix of loopback,
+ * GPIO, I2C and SPI requests. Every response is matched to its request by operation id.
+ *
+ * Results use the format of the loopback benchmark: one JSON object per line, prefixed with
+ * "GB_BENCH ". One line is printed per operation in the mix, followed by one for the whole mix.
+ *
+ * Build with: cc -O2 -Wall -o gb_tcp_bench gb_tcp_bench.c
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+#define MAX(a, b)     ((a) > (b) ? (a) : (b))
+
+#define NSEC_PER_SEC ((uint64_t)1000000000)
+
+/* Wire format, see subsys/greybus/transport/tcpip.c */
+#define GB_FRAME_CPORT_LEN  2
+#define GB_HDR_LEN          8
+#define GB_FRAME_HDR_LEN    (GB_FRAME_CPORT_LEN + GB_HDR_LEN)
+#define GB_MSG_SIZE_MAX     UINT16_MAX
+#define GB_RESPONSE(t)      ((t) | 0x80)
+#define GB_TYPE_IS_RESPONSE 0x80
+
+#define GB_CONTROL_CPORT          0
+#define GB_CONTROL_TYPE_CONNECTED 0x05
+#define GB_LOOPBACK_TYPE_PING     0x02
+#define GB_LOOPBACK_TYPE_TRANSFER 0x03
+#define GB_GPIO_TYPE_ACTIVATE     0x03
+#define GB_GPIO_TYPE_GET_VALUE    0x08
+#define GB_I2C_TYPE_TRANSFER      0x05
+#define GB_I2C_M_RD               0x0001
+#define GB_SPI_TYPE_TRANSFER      0x04
+#define GB_SPI_XFER_READ          0x01
+#define GB_SPI_XFER_WRITE         0x02
+
+#define GB_LOOPBACK_REQ_LEN 12
+#define GB_I2C_OP_LEN       6
+#define GB_SPI_XFER_LEN     13
+
+/* Target devices emulated by the benchmark node */
+#define BENCH_I2C_ADDR 0x50
+#define BENCH_SPI_CS   0
+#define BENCH_GPIO     0
+
+#define OPERATION_ID_MAX UINT16_MAX
+#define CONCURRENCY_MAX  1024
+/* Bounded by the buffer of the emulated I2C target */
+#define PAYLOAD_MAX      2048
+#define SETUP_TIMEOUT_MS 2000
+#define DRAIN_TIMEOUT_MS 2000
+#define IO_TIMEOUT_MS    10
+
+/* Largest request frame, the SPI transfer */
+#define FRAME_MAX   (GB_FRAME_HDR_LEN + 4 + GB_SPI_XFER_LEN + PAYLOAD_MAX)
+#define RX_BUF_SIZE (4 * GB_MSG_SIZE_MAX)
+/* Unsent frames all belong to operations in flight */
+#define TX_BUF_SIZE ((CONCURRENCY_MAX + 1) * FRAME_MAX)
+
+enum bench_op {
+	BENCH_OP_PING,
+	BENCH_OP_LOOPBACK,
+	BENCH_OP_GPIO,
+	BENCH_OP_I2C,
+	BENCH_OP_SPI,
+	BENCH_OP_COUNT,
+};
+
+/*
+ * struct bench_op_desc: An operation which can be part of the mix
+ *
+ * @name: name used on the command line and in the results
+ * @type: greybus request type
+ * @cport: cport the request is sent on
+ * @weight: relative frequency in the mix. 0 if not part of it.
+ */
+struct bench_op_desc {
+	const char *name;
+	uint8_t type;
+	uint16_t cport;
+	unsigned int weight;
+};
+
+/* Default cports match the layout of the benchmark node */
+static struct bench_op_desc ops[BENCH_OP_COUNT] = {
+	[BENCH_OP_PING] = {"ping", GB_LOOPBACK_TYPE_PING, 1, 0},
+	[BENCH_OP_LOOPBACK] = {"loopback", GB_LOOPBACK_TYPE_TRANSFER, 1, 1},
+	[BENCH_OP_GPIO] = {"gpio", GB_GPIO_TYPE_GET_VALUE, 2, 0},
+	[BENCH_OP_I2C] = {"i2c", GB_I2C_TYPE_TRANSFER, 4, 0},
+	[BENCH_OP_SPI] = {"spi", GB_SPI_TYPE_TRANSFER, 3, 0},
+};
+
+/*
+ * struct bench_samples: Latencies of completed operations
+ *
+ * @ns: latency of each operation
+ * @len: number of samples
+ * @cap: allocated number of samples
+ * @errors: operations which completed with a non zero result
+ * @bytes: payload bytes moved by the sampled operations
+ */
+struct bench_samples {
+	uint64_t *ns;
+	size_t len;
+	size_t cap;
+	uint64_t errors;
+	uint64_t bytes;
+};
+
+/*
+ * struct bench_inflight: Operation waiting for its response
+ *
+ * @sent_ns: time at which the request was queued
+ * @cport: cport the request was sent on
+ * @type: request type
+ * @op: operation kind. BENCH_OP_COUNT for setup requests, which are never sampled.
+ * @result: result of a completed setup request
+ * @used: slot is in use
+ */
+struct bench_inflight {
+	uint64_t sent_ns;
+	uint16_t cport;
+	uint8_t type;
+	uint8_t op;
+	uint8_t result;
+	bool used;
+};
+
+static struct {
+	const char *host;
+	const char *port;
+	unsigned int duration_s;
+	unsigned int warmup_s;
+	unsigned int concurrency;
+	size_t size;
+	uint32_t seed;
+} cfg = {
+	.host = "localhost",
+	.port = "4242",
+	.duration_s = 10,
+	.warmup_s = 1,
+	.concurrency = 1,
+	.size = 64,
+	.seed = 1,
+};
+
+static struct bench_samples samples[BENCH_OP_COUNT];
+static struct bench_inflight inflight[OPERATION_ID_MAX + 1];
+static unsigned int inflight_count;
+static uint16_t next_id;
+static unsigned int weight_total;
+/* Operations sent before this time are not sampled */
+static uint64_t measure_start_ns = UINT64_MAX;
+
+static uint8_t rx_buf[RX_BUF_SIZE];
+static size_t rx_len;
+static uint8_t tx_buf[TX_BUF_SIZE];
+static size_t tx_len;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = v >> 8;
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+	put_le16(p, v & 0xffff);
+	put_le16(p + 2, v >> 16);
+}
+
+static uint16_t get_le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+/* xorshift32, so that a mix can be replayed exactly */
+static uint32_t bench_rand(void)
+{
+	cfg.seed ^= cfg.seed << 13;
+	cfg.seed ^= cfg.seed >> 17;
+	cfg.seed ^= cfg.seed << 5;
+	return cfg.seed;
+}
+
+static size_t op_payload_len(enum bench_op op)
+{
+	switch (op) {
+	case BENCH_OP_LOOPBACK:
+	case BENCH_OP_I2C:
+	case BENCH_OP_SPI:
+		return cfg.size;
+	default:
+		return 0;
+	}
+}
+
+static uint16_t operation_id_alloc(void)
+{
+	do {
+		next_id = (next_id == OPERATION_ID_MAX) ? 1 : next_id + 1;
+	} while (inflight[next_id].used);
+
+	return next_id;
+}
+
+/* Appends a frame to the transmit buffer and returns its payload */
+static uint8_t *frame_append(uint16_t cport, uint8_t type, uint16_t id, size_t payload_len)
+{
+	uint8_t *frame = &tx_buf[tx_len];
+
+	put_le16(frame, cport);
+	put_le16(frame + 2, GB_HDR_LEN + payload_len);
+	put_le16(frame + 4, id);
+	frame[6] = type;
+	frame[7] = 0;
+	frame[8] = 0;
+	frame[9] = 0;
+
+	tx_len += GB_FRAME_HDR_LEN + payload_len;
+
+	return frame + GB_FRAME_HDR_LEN;
+}
+
+static void request_append(enum bench_op op, uint16_t id)
+{
+	uint8_t *p;
+	const size_t len = op_payload_len(op);
+	const struct bench_op_desc *d = &ops[op];
+
+	switch (op) {
+	case BENCH_OP_PING:
+		frame_append(d->cport, d->type, id, 0);
+		break;
+	case BENCH_OP_LOOPBACK:
+		p = frame_append(d->cport, d->type, id, GB_LOOPBACK_REQ_LEN + len);
+		put_le32(p, len);
+		put_le32(p + 4, 0);
+		put_le32(p + 8, 0);
+		memset(p + GB_LOOPBACK_REQ_LEN, 0xa5, len);
+		break;
+	case BENCH_OP_GPIO:
+		p = frame_append(d->cport, d->type, id, 1);
+		p[0] = BENCH_GPIO;
+		break;
+	case BENCH_OP_I2C:
+		/* Write a block to the target and read it back */
+		p = frame_append(d->cport, d->type, id, 2 + 2 * GB_I2C_OP_LEN + len);
+		put_le16(p, 2);
+		put_le16(p + 2, BENCH_I2C_ADDR);
+		put_le16(p + 4, 0);
+		put_le16(p + 6, len);
+		put_le16(p + 8, BENCH_I2C_ADDR);
+		put_le16(p + 10, GB_I2C_M_RD);
+		put_le16(p + 12, len);
+		memset(p + 2 + 2 * GB_I2C_OP_LEN, 0x5a, len);
+		break;
+	case BENCH_OP_SPI:
+		/* Single full duplex transfer */
+		p = frame_append(d->cport, d->type, id, 4 + GB_SPI_XFER_LEN + len);
+		p[0] = BENCH_SPI_CS;
+		p[1] = 0;
+		put_le16(p + 2, 1);
+		put_le32(p + 4, 1000000);
+		put_le32(p + 8, len);
+		put_le16(p + 12, 0);
+		p[14] = 0;
+		p[15] = 8;
+		p[16] = GB_SPI_XFER_READ | GB_SPI_XFER_WRITE;
+		memset(p + 4 + GB_SPI_XFER_LEN, 0x3c, len);
+		break;
+	default:
+		break;
+	}
+}
+
+static enum bench_op op_pick(void)
+{
+	size_t i;
+	unsigned int r = bench_rand() % weight_total;
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		if (r < ops[i].weight) {
+			return i;
+		}
+		r -= ops[i].weight;
+	}
+
+	return BENCH_OP_LOOPBACK;
+}
+
+static void inflight_add(uint16_t id, uint16_t cport, uint8_t type, uint8_t op)
+{
+	inflight[id].sent_ns = now_ns();
+	inflight[id].cport = cport;
+	inflight[id].type = type;
+	inflight[id].op = op;
+	inflight[id].used = true;
+	inflight_count++;
+}
+
+static void op_issue(void)
+{
+	const enum bench_op op = op_pick();
+	const uint16_t id = operation_id_alloc();
+
+	request_append(op, id);
+	inflight_add(id, ops[op].cport, ops[op].type, op);
+}
+
+static int sample_add(struct bench_samples *s, uint64_t ns)
+{
+	uint64_t *tmp;
+
+	if (s->len == s->cap) {
+		s->cap = s->cap ? 2 * s->cap : 4096;
+		tmp = realloc(s->ns, s->cap * sizeof(*tmp));
+		if (!tmp) {
+			return -ENOMEM;
+		}
+		s->ns = tmp;
+	}
+
+	s->ns[s->len++] = ns;
+	return 0;
+}
+
+static int tx_flush(int sock)
+{
+	ssize_t ret;
+
+	if (tx_len == 0) {
+		return 0;
+	}
+
+	ret = send(sock, tx_buf, tx_len, MSG_NOSIGNAL);
+	if (ret < 0) {
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -errno;
+	}
+
+	memmove(tx_buf, tx_buf + ret, tx_len - ret);
+	tx_len -= ret;
+
+	return 0;
+}
+
+/*
+ * Reads whatever is available and hands every complete frame to cb. Returns the number of frames
+ * or a negative error.
+ */
+static int rx_poll(int sock, void (*cb)(uint16_t cport, const uint8_t *hdr, uint64_t now))
+{
+	ssize_t ret;
+	size_t off = 0, frame_len;
+	int frames = 0;
+	const uint64_t now = now_ns();
+
+	ret = recv(sock, rx_buf + rx_len, sizeof(rx_buf) - rx_len, 0);
+	if (ret == 0) {
+		return -ECONNRESET;
+	}
+	if (ret < 0) {
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -errno;
+	}
+	rx_len += ret;
+
+	while (rx_len - off >= GB_FRAME_HDR_LEN) {
+		frame_len = GB_FRAME_CPORT_LEN + get_le16(rx_buf + off + GB_FRAME_CPORT_LEN);
+		if (frame_len < GB_FRAME_HDR_LEN) {
+			return -EPROTO;
+		}
+		if (rx_len - off < frame_len) {
+			break;
+		}
+
+		cb(get_le16(rx_buf + off), rx_buf + off + GB_FRAME_CPORT_LEN, now);
+		off += frame_len;
+		frames++;
+	}
+
+	memmove(rx_buf, rx_buf + off, rx_len - off);
+	rx_len -= off;
+
+	return frames;
+}
+
+static void response_handle(uint16_t cport, const uint8_t *hdr, uint64_t now)
+{
+	struct bench_inflight *op;
+	const uint16_t id = get_le16(hdr + 2);
+	const uint8_t type = hdr[4];
+	const uint8_t result = hdr[5];
+
+	/* Requests from the node, such as GPIO interrupts, are not part of the benchmark */
+	if (!(type & GB_TYPE_IS_RESPONSE) || id == 0) {
+		return;
+	}
+
+	op = &inflight[id];
+	if (!op->used || op->cport != cport || GB_RESPONSE(op->type) != type) {
+		fprintf(stderr, "unexpected response: cport %u id %u type 0x%02x\n", cport, id,
+			type);
+		return;
+	}
+
+	op->used = false;
+	op->result = result;
+	inflight_count--;
+
+	if (op->op == BENCH_OP_COUNT || op->sent_ns < measure_start_ns) {
+		return;
+	}
+
+	if (result) {
+		samples[op->op].errors++;
+		return;
+	}
+
+	samples[op->op].bytes += op_payload_len(op->op);
+	if (sample_add(&samples[op->op], now - op->sent_ns) < 0) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static int wait_io(int sock, int timeout_ms)
+{
+	struct pollfd fd = {
+		.fd = sock,
+		.events = POLLIN | (tx_len ? POLLOUT : 0),
+	};
+
+	if (poll(&fd, 1, timeout_ms) < 0) {
+		return -errno;
+	}
+
+	return fd.revents & (POLLERR | POLLHUP) ? -ECONNRESET : 0;
+}
+
+static int io_step(int sock, int timeout_ms)
+{
+	int ret;
+
+	ret = wait_io(sock, timeout_ms);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = tx_flush(sock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = rx_poll(sock, response_handle);
+	return ret < 0 ? ret : 0;
+}
+
+
+/* Sends a single request outside of the measurement and waits for its result */
+static int setup_request(int sock, uint16_t cport, uint8_t type, const uint8_t *payload, size_t len)
+{
+	int ret;
+	const uint16_t id = operation_id_alloc();
+	const uint64_t deadline = now_ns() + SETUP_TIMEOUT_MS * 1000000ULL;
+
+	memcpy(frame_append(cport, type, id, len), payload, len);
+	inflight_add(id, cport, type, BENCH_OP_COUNT);
+
+	while (inflight[id].used) {
+		if (now_ns() > deadline) {
+			return -ETIMEDOUT;
+		}
+
+		ret = io_step(sock, IO_TIMEOUT_MS);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return inflight[id].result ? -EIO : 0;
+}
+
+static int cport_connect(int sock, uint16_t cport)
+{
+	uint8_t req[2];
+
+	put_le16(req, cport);
+	return setup_request(sock, GB_CONTROL_CPORT, GB_CONTROL_TYPE_CONNECTED, req, sizeof(req));
+}
+
+static int setup(int sock)
+{
+	int ret;
+	size_t i, j;
+	const uint8_t gpio = BENCH_GPIO;
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		if (!ops[i].weight) {
+			continue;
+		}
+
+		/* Several operations can share a cport */
+		for (j = 0; j < i; j++) {
+			if (ops[j].weight && ops[j].cport == ops[i].cport) {
+				break;
+			}
+		}
+		if (j < i) {
+			continue;
+		}
+
+		ret = cport_connect(sock, ops[i].cport);
+		if (ret < 0) {
+			fprintf(stderr, "failed to connect cport %u: %s\n", ops[i].cport,
+				strerror(-ret));
+			return ret;
+		}
+	}
+
+	if (ops[BENCH_OP_GPIO].weight) {
+		ret = setup_request(sock, ops[BENCH_OP_GPIO].cport, GB_GPIO_TYPE_ACTIVATE, &gpio,
+				    sizeof(gpio));
+		if (ret < 0) {
+			fprintf(stderr, "failed to activate gpio %u: %s\n", gpio, strerror(-ret));
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int sock_connect(void)
+{
+	int sock = -1, ret;
+	const int yes = 1;
+	struct addrinfo *res, *ai;
+	const struct addrinfo hints = {
+		.ai_family = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+	};
+
+	ret = getaddrinfo(cfg.host, cfg.port, &hints, &res);
+	if (ret) {
+		fprintf(stderr, "%s: %s\n", cfg.host, gai_strerror(ret));
+		return -EINVAL;
+	}
+
+	for (ai = res; ai; ai = ai->ai_next) {
+		sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (sock < 0) {
+			continue;
+		}
+
+		if (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0) {
+			break;
+		}
+
+		close(sock);
+		sock = -1;
+	}
+
+	freeaddrinfo(res);
+
+	if (sock < 0) {
+		fprintf(stderr, "failed to connect to %s:%s\n", cfg.host, cfg.port);
+		return -ECONNREFUSED;
+	}
+
+	/* Batching is up to the node, the generator sends each window as soon as it can */
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+	fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+
+	return sock;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Nearest rank percentile of sorted samples, in per mille */
+static uint64_t percentile(const struct bench_samples *s, size_t per_mille)
+{
+	size_t rank = (per_mille * s->len + 999) / 1000;
+
+	return s->len ? s->ns[MAX(rank, 1) - 1] : 0;
+}
+
+static void report(const char *name, size_t payload, struct bench_samples *s, uint64_t window_ns)
+{
+	size_t i;
+	uint64_t total_ns = 0;
+
+	qsort(s->ns, s->len, sizeof(s->ns[0]), cmp_u64);
+	for (i = 0; i < s->len; i++) {
+		total_ns += s->ns[i];
+	}
+
+	window_ns = MAX(window_ns, 1);
+
+	printf("GB_BENCH {\"op\":\"%s\",\"payload\":%zu,\"concurrency\":%u,\"msgs\":%zu,"
+	       "\"errors\":%" PRIu64 ",\"msgs_per_s\":%" PRIu64 ",\"kbytes_per_s\":%" PRIu64 ","
+	       "\"mean_ns\":%" PRIu64 ",\"p50_ns\":%" PRIu64 ",\"p90_ns\":%" PRIu64 ","
+	       "\"p99_ns\":%" PRIu64 ",\"p999_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64 "}\n",
+	       name, payload, cfg.concurrency, s->len, s->errors,
+	       (uint64_t)s->len * NSEC_PER_SEC / window_ns,
+	       s->bytes * NSEC_PER_SEC / window_ns / 1024,
+	       s->len ? total_ns / s->len : 0, percentile(s, 500), percentile(s, 900),
+	       percentile(s, 990), percentile(s, 999), s->len ? s->ns[s->len - 1] : 0);
+}
+
+static void report_all(uint64_t window_ns)
+{
+	size_t i;
+	struct bench_samples all = {0};
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		all.cap += samples[i].len;
+	}
+
+	all.ns = malloc(MAX(all.cap, 1) * sizeof(all.ns[0]));
+	if (!all.ns) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		if (!ops[i].weight) {
+			continue;
+		}
+
+		report(ops[i].name, op_payload_len(i), &samples[i], window_ns);
+
+		memcpy(all.ns + all.len, samples[i].ns, samples[i].len * sizeof(all.ns[0]));
+		all.len += samples[i].len;
+		all.errors += samples[i].errors;
+		all.bytes += samples[i].bytes;
+	}
+
+	report("all", cfg.size, &all, window_ns);
+	free(all.ns);
+}
+
+static int run(int sock)
+{
+	int ret;
+	uint64_t deadline;
+	const uint64_t start = now_ns();
+	const uint64_t stop = start + (uint64_t)(cfg.warmup_s + cfg.duration_s) * NSEC_PER_SEC;
+
+	measure_start_ns = start + (uint64_t)cfg.warmup_s * NSEC_PER_SEC;
+
+	while (now_ns() < stop) {
+		while (inflight_count < cfg.concurrency) {
+			op_issue();
+		}
+
+		ret = io_step(sock, IO_TIMEOUT_MS);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	deadline = now_ns() + DRAIN_TIMEOUT_MS * 1000000ULL;
+	while (inflight_count && now_ns() < deadline) {
+		ret = io_step(sock, IO_TIMEOUT_MS);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (inflight_count) {
+		fprintf(stderr, "%u operations did not complete\n", inflight_count);
+	}
+
+	report_all(stop - measure_start_ns);
+
+	return inflight_count ? -ETIMEDOUT : 0;
+}
+
+static int op_find(const char *name, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		if (strlen(ops[i].name) == len && !strncmp(ops[i].name, name, len)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* Parses a comma separated list of op[@cport][:weight] */
+static int mix_parse(const char *arg)
+{
+	int op;
+	size_t i, len;
+	char *end;
+	const char *p = arg;
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		ops[i].weight = 0;
+	}
+
+	while (*p) {
+		len = strcspn(p, "@:,");
+		op = op_find(p, len);
+		if (op < 0) {
+			fprintf(stderr, "unknown operation: %.*s\n", (int)len, p);
+			return -EINVAL;
+		}
+		p += len;
+
+		if (*p == '@') {
+			ops[op].cport = strtoul(p + 1, &end, 0);
+			p = end;
+		}
+
+		ops[op].weight = 1;
+		if (*p == ':') {
+			ops[op].weight = strtoul(p + 1, &end, 0);
+			p = end;
+		}
+
+		if (*p == ',') {
+			p++;
+		} else if (*p) {
+			fprintf(stderr, "invalid mix: %s\n", arg);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -H HOST     node address (default %s)\n"
+		"  -p PORT     node port (default %s)\n"
+		"  -d SECONDS  measurement duration (default %u)\n"
+		"  -w SECONDS  warmup before measuring (default %u)\n"
+		"  -c N        operations kept in flight, 1 to %u (default %u)\n"
+		"  -s BYTES    payload of loopback, I2C and SPI operations,\n"
+		"              up to %u (default %zu)\n"
+		"  -m MIX      comma separated op[@cport][:weight], where op is one of\n"
+		"              ping, loopback, gpio, i2c, spi (default loopback)\n"
+		"  -r SEED     seed of the operation mix (default %u)\n",
+		prog, cfg.host, cfg.port, cfg.duration_s, cfg.warmup_s, CONCURRENCY_MAX,
+		cfg.concurrency, PAYLOAD_MAX, cfg.size, cfg.seed);
+}
+
+int main(int argc, char *argv[])
+{
+	int opt, sock, ret;
+	size_t i;
+
+	while ((opt = getopt(argc, argv, "H:p:d:w:c:s:m:r:h")) != -1) {
+		switch (opt) {
+		case 'H':
+			cfg.host = optarg;
+			break;
+		case 'p':
+			cfg.port = optarg;
+			break;
+		case 'd':
+			cfg.duration_s = strtoul(optarg, NULL, 0);
+			break;
+		case 'w':
+			cfg.warmup_s = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			cfg.concurrency = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			cfg.size = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			if (mix_parse(optarg) < 0) {
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'r':
+			cfg.seed = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (cfg.concurrency < 1 || cfg.concurrency > CONCURRENCY_MAX || cfg.size > PAYLOAD_MAX ||
+	    cfg.duration_s == 0 || cfg.seed == 0) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		weight_total += ops[i].weight;
+	}
+	if (weight_total == 0) {
+		fprintf(stderr, "empty mix\n");
+		return EXIT_FAILURE;
+	}
+
+	sock = sock_connect();
+	if (sock < 0) {
+		return EXIT_FAILURE;
+	}
+
+	ret = setup(sock);
+	if (ret == 0) {
+		ret = run(sock);
+	}
+
+	close(sock);
+
+	if (ret < 0 && ret != -ETIMEDOUT) {
+		fprintf(stderr, "benchmark failed: %s\n", strerror(-ret));
+	}
+
+	return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
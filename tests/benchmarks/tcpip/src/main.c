@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Greybus node for the TCP/IP transport benchmark. The node exposes a loopback cport and a bridged
+ * phy bundle with emulated GPIO, I2C and SPI controllers. Traffic is generated by the host tool in
+ * host/, which connects to the node over the sockets offloaded to the host.
+ *
+ * CPort layout: 0 control, 1 loopback, 2 GPIO, 3 SPI, 4 I2C.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/spi_emul.h>
+#include <greybus-utils/manifest.h>
+
+/* Must match the defaults of the host tool */
+#define BENCH_I2C_ADDR 0x50
+#define BENCH_SPI_CS   0
+
+BUILD_ASSERT(GREYBUS_CPORT_COUNT == 5, "Unexpected cport layout");
+
+static const struct device *i2c_bus = DEVICE_DT_GET(DT_NODELABEL(i2c0));
+static const struct device *spi_bus = DEVICE_DT_GET(DT_NODELABEL(spi0));
+
+/* Data written to the I2C target is read back by the following read */
+static uint8_t i2c_mem[2048];
+static size_t i2c_mem_len;
+
+static int i2c_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+			     int addr)
+{
+	int i;
+
+	ARG_UNUSED(target);
+	ARG_UNUSED(addr);
+
+	for (i = 0; i < num_msgs; i++) {
+		if (msgs[i].len > sizeof(i2c_mem)) {
+			return -EIO;
+		}
+
+		if (msgs[i].flags & I2C_MSG_READ) {
+			memcpy(msgs[i].buf, i2c_mem, MIN(msgs[i].len, i2c_mem_len));
+		} else {
+			memcpy(i2c_mem, msgs[i].buf, msgs[i].len);
+			i2c_mem_len = msgs[i].len;
+		}
+	}
+
+	return 0;
+}
+
+/* Shift register: every byte clocked out is clocked back in */
+static int spi_emul_io(const struct emul *target, const struct spi_config *config,
+		       const struct spi_buf_set *tx_bufs, const struct spi_buf_set *rx_bufs)
+{
+	size_t i, len;
+	const struct spi_buf *tx;
+
+	ARG_UNUSED(target);
+	ARG_UNUSED(config);
+
+	if (!rx_bufs) {
+		return 0;
+	}
+
+	for (i = 0; i < rx_bufs->count; i++) {
+		if (!rx_bufs->buffers[i].buf) {
+			continue;
+		}
+
+		tx = (tx_bufs && i < tx_bufs->count) ? &tx_bufs->buffers[i] : NULL;
+		len = (tx && tx->buf) ? MIN(tx->len, rx_bufs->buffers[i].len) : 0;
+
+		if (len) {
+			memcpy(rx_bufs->buffers[i].buf, tx->buf, len);
+		}
+		memset((uint8_t *)rx_bufs->buffers[i].buf + len, 0, rx_bufs->buffers[i].len - len);
+	}
+
+	return 0;
+}
+
+static const struct i2c_emul_api i2c_api = {
+	.transfer = i2c_emul_transfer,
+};
+
+static const struct spi_emul_api spi_api = {
+	.io = spi_emul_io,
+};
+
+static const struct device i2c_target_dev = {
+	.name = "bench-i2c",
+};
+
+static const struct device spi_target_dev = {
+	.name = "bench-spi",
+};
+
+static const struct emul i2c_target = {
+	.dev = &i2c_target_dev,
+};
+
+static const struct emul spi_target = {
+	.dev = &spi_target_dev,
+};
+
+static struct i2c_emul i2c_emul = {
+	.addr = BENCH_I2C_ADDR,
+	.api = &i2c_api,
+	.target = &i2c_target,
+};
+
+static struct spi_emul spi_emul = {
+	.chipsel = BENCH_SPI_CS,
+	.api = &spi_api,
+	.target = &spi_target,
+};
+
+int main(void)
+{
+	int ret;
+
+	ret = i2c_emul_register(i2c_bus, &i2c_emul);
+	if (ret < 0) {
+		printk("GB_BENCH FAILED i2c emulator: %d\n", ret);
+		return ret;
+	}
+
+	ret = spi_emul_register(spi_bus, &spi_emul);
+	if (ret < 0) {
+		printk("GB_BENCH FAILED spi emulator: %d\n", ret);
+		return ret;
+	}
+
+	printk("GB_BENCH READY\n");
+
+	return 0;
+}
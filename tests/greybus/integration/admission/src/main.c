@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus/greybus_stats.h>
+#include <greybus-utils/manifest.h>
+
+#define CONTROL_CPORT  0
+#define LOOPBACK_CPORT 1
+#define PING_TYPE      0x00
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+static void submit(uint16_t cport, uint8_t type, bool oneshot)
+{
+	struct gb_message *req = gb_message_request_alloc(0, type, oneshot);
+
+	zassert_ok(greybus_rx_handler(cport, req), "Request not handled");
+}
+
+/* Refused requests are answered right away, from the caller of greybus_rx_handler */
+static void expect_retry(uint16_t cport)
+{
+	struct gb_msg_with_cport resp = gb_transport_get_message();
+
+	zassert_equal(resp.cport, cport, "Response on wrong cport");
+	zassert_equal(resp.msg->header.result, GB_OP_RETRY, "Request not refused");
+	gb_message_dealloc(resp.msg);
+}
+
+static void expect_success(size_t count)
+{
+	size_t i;
+	struct gb_msg_with_cport resp;
+
+	for (i = 0; i < count; i++) {
+		resp = gb_transport_get_message();
+		zassert_true(gb_message_is_success(resp.msg), "Queued request failed");
+		gb_message_dealloc(resp.msg);
+	}
+}
+
+static uint32_t refused(uint16_t cport)
+{
+	struct gb_stats_cport stats;
+
+	zassert_ok(gb_stats_cport_get(cport, &stats));
+	return stats.rx_refused;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	gb_stats_reset();
+}
+
+ZTEST_SUITE(greybus_admission_tests, NULL, NULL, before, NULL, NULL);
+
+ZTEST(greybus_admission_tests, test_queue_depth)
+{
+	size_t i;
+
+	/* Keep the workers from draining the queue */
+	k_sched_lock();
+	for (i = 0; i < CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH; i++) {
+		submit(CONTROL_CPORT, PING_TYPE, false);
+	}
+	submit(CONTROL_CPORT, PING_TYPE, false);
+	expect_retry(CONTROL_CPORT);
+	k_sched_unlock();
+
+	expect_success(CONFIG_GREYBUS_DISPATCH_QUEUE_DEPTH);
+	zassert_equal(refused(CONTROL_CPORT), 1, "Refusal not counted");
+}
+
+ZTEST(greybus_admission_tests, test_control_reserve)
+{
+	const size_t budget =
+		CONFIG_GREYBUS_DISPATCH_MAX_PENDING - CONFIG_GREYBUS_DISPATCH_CONTROL_RESERVE;
+	size_t i;
+
+	k_sched_lock();
+	for (i = 0; i < budget; i++) {
+		submit(LOOPBACK_CPORT, GB_LOOPBACK_TYPE_PING, false);
+	}
+	submit(LOOPBACK_CPORT, GB_LOOPBACK_TYPE_PING, false);
+	expect_retry(LOOPBACK_CPORT);
+
+	/* Control cport can still use the reserve */
+	for (i = 0; i < CONFIG_GREYBUS_DISPATCH_CONTROL_RESERVE; i++) {
+		submit(CONTROL_CPORT, PING_TYPE, false);
+	}
+	submit(CONTROL_CPORT, PING_TYPE, false);
+	expect_retry(CONTROL_CPORT);
+	k_sched_unlock();
+
+	expect_success(CONFIG_GREYBUS_DISPATCH_MAX_PENDING);
+	zassert_equal(refused(LOOPBACK_CPORT), 1, "Refusal not counted");
+	zassert_equal(refused(CONTROL_CPORT), 1, "Refusal not counted");
+}
+
+ZTEST(greybus_admission_tests, test_driver_queue_depth)
+{
+	/* Telemetry driver queues a single request */
+	k_sched_lock();
+	submit(GREYBUS_TELEMETRY_CPORT, GB_TELEMETRY_TYPE_SUMMARY, false);
+	submit(GREYBUS_TELEMETRY_CPORT, GB_TELEMETRY_TYPE_SUMMARY, false);
+	expect_retry(GREYBUS_TELEMETRY_CPORT);
+	k_sched_unlock();
+
+	expect_success(1);
+}
+
+ZTEST(greybus_admission_tests, test_unidirectional_dropped)
+{
+	k_sched_lock();
+	submit(LOOPBACK_CPORT, GB_LOOPBACK_TYPE_PING, false);
+	submit(LOOPBACK_CPORT, GB_LOOPBACK_TYPE_PING, false);
+	submit(LOOPBACK_CPORT, GB_LOOPBACK_TYPE_SINK, true);
+	k_sched_unlock();
+
+	/* Nothing is sent for the dropped request */
+	expect_success(2);
+	zassert_equal(refused(LOOPBACK_CPORT), 1, "Drop not counted");
+}
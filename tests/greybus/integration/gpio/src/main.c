@@ -12,6 +12,7 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/gpio/gpio_emul.h>
+#include "greybus_heap.h"
 
 static const struct device *dev = DEVICE_DT_GET(DT_NODELABEL(gpio0));
 
@@ -136,6 +137,44 @@ ZTEST(greybus_gpio_tests, test_get_value)
 	gb_message_dealloc(resp.msg);
 }
 
+#ifdef CONFIG_GREYBUS_MESSAGE_POOL
+static uint32_t message_allocs(void)
+{
+	size_t i;
+	uint32_t allocs = 0;
+	struct gb_message_pool_stats stats;
+
+	for (i = 0; i < gb_message_pool_class_count(); i++) {
+		gb_message_pool_stats_get(i, &stats);
+		allocs += stats.allocs;
+	}
+
+	return allocs;
+}
+
+ZTEST(greybus_gpio_tests, test_get_value_not_allocated)
+{
+	uint32_t allocs;
+	struct gb_msg_with_cport resp;
+	struct gb_gpio_get_value_request *req_data;
+	struct gb_message *msg =
+		gb_message_request_alloc(sizeof(*req_data), GB_GPIO_TYPE_GET_VALUE, false);
+
+	req_data = (struct gb_gpio_get_value_request *)msg->payload;
+	req_data->which = 0;
+
+	allocs = message_allocs();
+	greybus_rx_handler(1, msg);
+	resp = get_first_non_event_checked(GB_RESPONSE(GB_GPIO_TYPE_GET_VALUE),
+					   sizeof(struct gb_gpio_get_value_response));
+
+	/* Only the copy kept by the dummy transport for the test is allocated */
+	zassert_equal(message_allocs() - allocs, 1, "Response was allocated");
+
+	gb_message_dealloc(resp.msg);
+}
+#endif // CONFIG_GREYBUS_MESSAGE_POOL
+
 ZTEST(greybus_gpio_tests, test_direction_out)
 {
 	struct gb_msg_with_cport resp;
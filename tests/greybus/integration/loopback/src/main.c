@@ -145,3 +145,82 @@ ZTEST(greybus_loopback_tests, test_rapid_pings)
 		gb_message_dealloc(resp.msg);
 	}
 }
+
+ZTEST(greybus_loopback_tests, test_transfer_not_copied)
+{
+	struct gb_msg_with_cport resp;
+	struct gb_message *req =
+		gb_message_request_alloc(sizeof(struct gb_loopback_transfer_request) + REQ_SIZE,
+					 GB_LOOPBACK_TYPE_TRANSFER, false);
+	struct gb_loopback_transfer_request *req_data =
+		(struct gb_loopback_transfer_request *)req->payload;
+
+	req_data->len = sys_cpu_to_le32(REQ_SIZE);
+
+	/* The request is turned into the response and handed over to the transport */
+	greybus_rx_handler(1, req);
+	resp = gb_transport_get_message();
+	zassert_true(gb_message_is_success(resp.msg), "Greybus loopback transfer failed");
+	zassert_equal_ptr(resp.msg, req, "Response was copied");
+
+	gb_message_dealloc(resp.msg);
+}
+
+ZTEST(greybus_loopback_tests, test_message_get)
+{
+	struct gb_message *msg = gb_message_request_alloc(REQ_SIZE, GB_LOOPBACK_TYPE_SINK, true);
+	struct gb_message *ref;
+
+	memset(msg->payload, 0xaa, REQ_SIZE);
+
+	ref = gb_message_get(msg);
+	zassert_not_null(ref, "Failed to get message");
+	if (IS_ENABLED(CONFIG_GREYBUS_MESSAGE_REFCOUNT)) {
+		zassert_equal_ptr(ref, msg, "Referenced message was copied");
+	}
+
+	/* Still valid after the first reference is dropped */
+	gb_message_put(msg);
+	zassert_equal(gb_message_payload_len(ref), REQ_SIZE, "Invalid message size");
+	zassert_equal(ref->payload[REQ_SIZE - 1], 0xaa, "Invalid message data");
+
+	gb_message_put(ref);
+}
+
+ZTEST(greybus_loopback_tests, test_response_reserve)
+{
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_TRANSFER, false);
+	struct gb_message *resp = gb_message_response_reserve(req, REQ_SIZE);
+
+	zassert_not_null(resp, "Failed to reserve response");
+	zassert_equal(gb_message_type(resp), GB_RESPONSE(GB_LOOPBACK_TYPE_TRANSFER),
+		      "Invalid response type");
+	zassert_equal(resp->header.operation_id, req->header.operation_id,
+		      "Invalid operation id");
+	zassert_true(gb_message_is_success(resp), "Response not successful");
+	zassert_equal(gb_message_payload_len(resp), REQ_SIZE, "Invalid reserved size");
+
+	resp->payload[0] = 0x55;
+	gb_message_response_commit(resp, 1);
+	zassert_equal(gb_message_payload_len(resp), 1, "Invalid committed size");
+	zassert_equal(resp->payload[0], 0x55, "Payload changed on commit");
+
+	gb_message_dealloc(resp);
+	gb_message_dealloc(req);
+}
+
+#ifdef CONFIG_GREYBUS_STATIC_MEMORY
+ZTEST(greybus_loopback_tests, test_no_heap_fallback)
+{
+	const size_t max = CONFIG_GREYBUS_MAX_PAYLOAD_SIZE;
+	struct gb_message *msg = gb_message_request_alloc(
+		CONFIG_GREYBUS_MESSAGE_POOL_LARGE_SIZE + 1, GB_LOOPBACK_TYPE_SINK, true);
+
+	/* Larger than every pool, and there is no heap to fall back on */
+	zassert_is_null(msg, "Oversized message allocated");
+
+	msg = gb_message_request_alloc(max, GB_LOOPBACK_TYPE_SINK, true);
+	zassert_not_null(msg, "Failed to allocate largest message");
+	gb_message_dealloc(msg);
+}
+#endif // CONFIG_GREYBUS_STATIC_MEMORY
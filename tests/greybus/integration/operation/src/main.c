@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_operation.h"
+
+#define LOOPBACK_CPORT 1
+#define OP_ID(msg)     sys_le16_to_cpu((msg)->header.operation_id)
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+struct op_result {
+	struct k_sem done;
+	struct gb_message *resp;
+	int status;
+};
+
+static struct op_result result;
+
+static void op_callback(uint16_t cport, struct gb_message *resp, int status, void *priv)
+{
+	struct op_result *res = priv;
+
+	zassert_equal(cport, LOOPBACK_CPORT, "Invalid cport");
+
+	res->resp = resp;
+	res->status = status;
+	k_sem_give(&res->done);
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_init(&result.done, 0, 1);
+	result.resp = NULL;
+	result.status = 1;
+}
+
+ZTEST_SUITE(greybus_operation_tests, NULL, NULL, before, NULL, NULL);
+
+ZTEST(greybus_operation_tests, test_response)
+{
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+	struct gb_message *resp = gb_message_response_alloc_from_req(NULL, 0, req, GB_OP_SUCCESS);
+
+	zassert_ok(gb_operation_track(LOOPBACK_CPORT, req, op_callback, &result, K_SECONDS(1)));
+
+	greybus_rx_handler(LOOPBACK_CPORT, resp);
+
+	zassert_ok(k_sem_take(&result.done, K_SECONDS(1)), "Callback not called");
+	zassert_ok(result.status, "Operation should succeed");
+	zassert_not_null(result.resp, "Response missing");
+	zassert_equal(result.resp->header.operation_id, req->header.operation_id,
+		      "Response does not match request");
+
+	gb_message_dealloc(result.resp);
+	gb_message_dealloc(req);
+}
+
+ZTEST(greybus_operation_tests, test_timeout)
+{
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+
+	zassert_ok(gb_operation_track(LOOPBACK_CPORT, req, op_callback, &result, K_MSEC(10)));
+
+	zassert_ok(k_sem_take(&result.done, K_SECONDS(1)), "Callback not called");
+	zassert_equal(result.status, -ETIMEDOUT, "Operation should time out");
+	zassert_is_null(result.resp, "Timed out operation should not have response");
+
+	gb_message_dealloc(req);
+}
+
+ZTEST(greybus_operation_tests, test_cancel)
+{
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+
+	zassert_ok(gb_operation_track(LOOPBACK_CPORT, req, op_callback, &result, K_MSEC(10)));
+	zassert_true(gb_operation_cancel(LOOPBACK_CPORT, OP_ID(req)),
+		     "Operation should be in flight");
+	zassert_false(gb_operation_cancel(LOOPBACK_CPORT, OP_ID(req)),
+		      "Operation should not be in flight");
+
+	zassert_equal(k_sem_take(&result.done, K_MSEC(50)), -EAGAIN,
+		      "Callback called for cancelled operation");
+
+	gb_message_dealloc(req);
+}
+
+ZTEST(greybus_operation_tests, test_invalid)
+{
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, true);
+
+	zassert_equal(gb_operation_track(LOOPBACK_CPORT, req, op_callback, &result, K_MSEC(10)),
+		      -EINVAL, "Unidirectional requests cannot be tracked");
+
+	gb_message_dealloc(req);
+}
+
+ZTEST(greybus_operation_tests, test_duplicate)
+{
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+
+	zassert_ok(gb_operation_track(LOOPBACK_CPORT, req, NULL, NULL, K_MSEC(10)));
+	zassert_equal(gb_operation_track(LOOPBACK_CPORT, req, NULL, NULL, K_MSEC(10)), -EBUSY,
+		      "Operation id already in flight");
+	zassert_true(gb_operation_cancel(LOOPBACK_CPORT, OP_ID(req)));
+
+	gb_message_dealloc(req);
+}
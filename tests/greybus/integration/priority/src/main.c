@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_cport.h"
+
+#define CONTROL_CPORT  0
+#define LOOPBACK_CPORT 1
+#define GPIO_CPORT     2
+#define PING_TYPE      0x00
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+static void submit(uint16_t cport)
+{
+	struct gb_message *req = gb_message_request_alloc(0, PING_TYPE, false);
+
+	zassert_ok(greybus_rx_handler(cport, req), "Request not handled");
+}
+
+/* Submit all requests before the worker can run, and return the cports of the responses */
+static void dispatch(const uint16_t *cports, uint16_t *order, size_t count)
+{
+	size_t i;
+	struct gb_msg_with_cport resp;
+
+	k_sched_lock();
+	for (i = 0; i < count; i++) {
+		submit(cports[i]);
+	}
+	k_sched_unlock();
+
+	for (i = 0; i < count; i++) {
+		resp = gb_transport_get_message();
+		zassert_true(gb_message_is_success(resp.msg), "Request failed");
+		order[i] = resp.cport;
+		gb_message_dealloc(resp.msg);
+	}
+}
+
+ZTEST_SUITE(greybus_priority_tests, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(greybus_priority_tests, test_classes)
+{
+	zassert_equal(gb_cport_get(CONTROL_CPORT)->priority, GB_CPORT_PRIORITY_CONTROL,
+		      "Invalid control priority");
+	zassert_equal(gb_cport_get(LOOPBACK_CPORT)->priority, GB_CPORT_PRIORITY_BULK,
+		      "Invalid default priority");
+	zassert_equal(gb_cport_get(GPIO_CPORT)->priority, GB_CPORT_PRIORITY_BULK,
+		      "Devicetree priority not applied");
+}
+
+ZTEST(greybus_priority_tests, test_control_first)
+{
+	const uint16_t cports[] = {LOOPBACK_CPORT, LOOPBACK_CPORT, CONTROL_CPORT};
+	uint16_t order[ARRAY_SIZE(cports)];
+
+	dispatch(cports, order, ARRAY_SIZE(cports));
+
+	zassert_equal(order[0], CONTROL_CPORT, "Control not served first");
+	zassert_equal(order[1], LOOPBACK_CPORT, "Unexpected order");
+	zassert_equal(order[2], LOOPBACK_CPORT, "Unexpected order");
+}
+
+ZTEST(greybus_priority_tests, test_aging)
+{
+	const uint16_t cports[] = {LOOPBACK_CPORT, CONTROL_CPORT, CONTROL_CPORT, CONTROL_CPORT,
+				   CONTROL_CPORT};
+	uint16_t order[ARRAY_SIZE(cports)];
+
+	dispatch(cports, order, ARRAY_SIZE(cports));
+
+	/* Bulk cport is served once control has been preferred DISPATCH_AGING times */
+	zassert_equal(order[CONFIG_GREYBUS_DISPATCH_AGING], LOOPBACK_CPORT, "Bulk cport starved");
+}
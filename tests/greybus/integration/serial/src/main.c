@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/sys/crc.h>
+#include <greybus/greybus.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_frame.h"
+#include "transport/serial.h"
+
+#define LOOPBACK_CPORT 1
+#define FRAME_MAX      256
+#define TRANSFER_SIZE  8
+
+static const struct device *dev = DEVICE_DT_GET(DT_NODELABEL(euart0));
+
+static size_t escape(uint8_t *out, const uint8_t *data, size_t len)
+{
+	size_t i, pos = 0;
+
+	for (i = 0; i < len; i++) {
+		if (data[i] == GB_FRAME_FLAG || data[i] == GB_FRAME_ESCAPE) {
+			out[pos++] = GB_FRAME_ESCAPE;
+			out[pos++] = data[i] ^ GB_FRAME_ESCAPE_XOR;
+		} else {
+			out[pos++] = data[i];
+		}
+	}
+
+	return pos;
+}
+
+/* Encode a message the way the AP would */
+static size_t encode(uint8_t *out, uint16_t cport, const struct gb_message *msg)
+{
+	size_t pos = 0;
+	uint8_t raw[FRAME_MAX];
+	const size_t len = sys_le16_to_cpu(msg->header.size);
+
+	sys_put_le16(cport, raw);
+	memcpy(raw + sizeof(__le16), msg, len);
+	sys_put_le16(crc16_ccitt(GB_FRAME_CRC_INIT, raw, sizeof(__le16) + len) ^
+			     GB_FRAME_CRC_XOROUT,
+		     raw + sizeof(__le16) + len);
+
+	out[pos++] = GB_FRAME_FLAG;
+	pos += escape(out + pos, raw, sizeof(__le16) * 2 + len);
+	out[pos++] = GB_FRAME_FLAG;
+
+	return pos;
+}
+
+static size_t ping_frame(uint8_t *out)
+{
+	size_t len;
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+
+	len = encode(out, LOOPBACK_CPORT, req);
+	gb_message_dealloc(req);
+
+	return len;
+}
+
+static void put(const uint8_t *data, size_t len)
+{
+	zassert_equal(uart_emul_put_rx_data(dev, data, len), len, "Failed to put rx data");
+}
+
+/*
+ * Read the next frame transmitted by the node, and return the unescaped cport and message
+ * without the frame check sequence
+ */
+static size_t get_frame(uint8_t *out)
+{
+	int i;
+	uint8_t byte;
+	size_t len = 0;
+	bool started = false, escaped = false;
+
+	for (i = 0; i < 100;) {
+		if (uart_emul_get_tx_data(dev, &byte, 1) == 0) {
+			k_msleep(1);
+			i++;
+			continue;
+		}
+
+		if (byte == GB_FRAME_FLAG) {
+			if (started && len) {
+				break;
+			}
+			started = true;
+		} else if (byte == GB_FRAME_ESCAPE) {
+			escaped = true;
+		} else {
+			zassert_true(started, "Data outside of a frame");
+			zassert_true(len < FRAME_MAX, "Frame too long");
+			out[len++] = escaped ? byte ^ GB_FRAME_ESCAPE_XOR : byte;
+			escaped = false;
+		}
+	}
+
+	zassert_true(len > sizeof(__le16) * 2, "No frame transmitted");
+	zassert_equal(crc16_ccitt(GB_FRAME_CRC_INIT, out, len - sizeof(__le16)) ^
+			      GB_FRAME_CRC_XOROUT,
+		      sys_get_le16(out + len - sizeof(__le16)), "Invalid frame check sequence");
+
+	return len - sizeof(__le16);
+}
+
+static void expect_pong(void)
+{
+	uint8_t frame[FRAME_MAX];
+	const struct gb_operation_msg_hdr *hdr = (const void *)(frame + sizeof(__le16));
+	const size_t len = get_frame(frame);
+
+	zassert_equal(len, sizeof(__le16) + sizeof(*hdr), "Invalid frame size");
+	zassert_equal(sys_get_le16(frame), LOOPBACK_CPORT, "Response on wrong cport");
+	zassert_equal(hdr->type, GB_RESPONSE(GB_LOOPBACK_TYPE_PING), "Invalid response type");
+	zassert_equal(hdr->result, GB_OP_SUCCESS, "Ping failed");
+}
+
+static void expect_nothing(void)
+{
+	uint8_t byte;
+
+	k_msleep(20);
+	zassert_equal(uart_emul_get_tx_data(dev, &byte, 1), 0, "Unexpected response");
+}
+
+static struct gb_serial_stats stats(void)
+{
+	struct gb_serial_stats s;
+
+	gb_serial_stats_get(&s);
+	return s;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	uart_emul_flush_tx_data(dev);
+}
+
+ZTEST_SUITE(greybus_serial_tests, NULL, NULL, before, NULL, NULL);
+
+ZTEST(greybus_serial_tests, test_ping)
+{
+	uint8_t frame[FRAME_MAX];
+
+	put(frame, ping_frame(frame));
+	expect_pong();
+}
+
+ZTEST(greybus_serial_tests, test_escaped_transfer)
+{
+	size_t i, len;
+	uint8_t frame[FRAME_MAX * 2];
+	const struct gb_loopback_transfer_response *resp_data;
+	struct gb_loopback_transfer_request *req_data;
+	struct gb_message *req = gb_message_request_alloc(sizeof(*req_data) + TRANSFER_SIZE,
+							  GB_LOOPBACK_TYPE_TRANSFER, false);
+
+	req_data = (struct gb_loopback_transfer_request *)req->payload;
+
+	/* Payload full of bytes which must be escaped */
+	req_data->len = sys_cpu_to_le32(TRANSFER_SIZE);
+	for (i = 0; i < TRANSFER_SIZE; i++) {
+		req_data->data[i] = (i % 2) ? GB_FRAME_FLAG : GB_FRAME_ESCAPE;
+	}
+
+	put(frame, encode(frame, LOOPBACK_CPORT, req));
+	gb_message_dealloc(req);
+
+	len = get_frame(frame);
+	resp_data = (const void *)(frame + sizeof(__le16) + sizeof(struct gb_operation_msg_hdr));
+	zassert_equal(len, sizeof(__le16) + sizeof(struct gb_operation_msg_hdr) +
+				   sizeof(*resp_data) + TRANSFER_SIZE,
+		      "Invalid frame size");
+	for (i = 0; i < TRANSFER_SIZE; i++) {
+		zassert_equal(resp_data->data[i], (i % 2) ? GB_FRAME_FLAG : GB_FRAME_ESCAPE,
+			      "Invalid data at %zu", i);
+	}
+}
+
+ZTEST(greybus_serial_tests, test_bad_crc_dropped)
+{
+	uint8_t frame[FRAME_MAX];
+	const uint32_t errors = stats().rx_crc_errors;
+	const size_t len = ping_frame(frame);
+
+	/* Change the cport without fixing the frame check sequence */
+	frame[1] ^= 0x02;
+	put(frame, len);
+	expect_nothing();
+	zassert_equal(stats().rx_crc_errors, errors + 1, "CRC error not counted");
+
+	/* The next frame is still received */
+	put(frame, ping_frame(frame));
+	expect_pong();
+}
+
+ZTEST(greybus_serial_tests, test_resync)
+{
+	uint8_t frame[FRAME_MAX];
+	const uint8_t garbage[] = {GB_FRAME_FLAG, 0x12, 0x34, 0x56};
+	const uint32_t errors = stats().rx_framing_errors;
+
+	/* Bytes without a frame are dropped on the next flag */
+	put(garbage, sizeof(garbage));
+	put(frame, ping_frame(frame));
+	expect_pong();
+	zassert_equal(stats().rx_framing_errors, errors + 1, "Framing error not counted");
+}
+
+ZTEST(greybus_serial_tests, test_split_frame)
+{
+	size_t i;
+	uint8_t frame[FRAME_MAX];
+	const size_t len = ping_frame(frame);
+
+	/* Frame trickles in over several DMA buffers */
+	for (i = 0; i < len; i++) {
+		put(&frame[i], 1);
+		k_msleep(1);
+	}
+
+	expect_pong();
+}
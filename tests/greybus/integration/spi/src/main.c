@@ -15,6 +15,7 @@
 
 #define OP_COUNT     3
 #define TRANSFER_BUF 128
+#define PING_TYPE    0x00
 
 static const struct device *dev = DEVICE_DT_GET(DT_NODELABEL(spi0));
 
@@ -65,7 +66,14 @@ static struct spi_emul spi_emul = {
 	.chipsel = 0,
 };
 
-ZTEST_SUITE(greybus_spi_tests, NULL, NULL, NULL, NULL, NULL);
+static void *setup(void)
+{
+	zassert_ok(spi_emul_register(dev, &spi_emul), "Failed to register spi device");
+
+	return NULL;
+}
+
+ZTEST_SUITE(greybus_spi_tests, NULL, setup, NULL, NULL, NULL);
 
 ZTEST(greybus_spi_tests, test_cport_count)
 {
@@ -74,7 +82,7 @@ ZTEST(greybus_spi_tests, test_cport_count)
 
 ZTEST(greybus_spi_tests, test_transfer)
 {
-	int i, ret;
+	int i;
 	uint8_t *write_data;
 	struct gb_msg_with_cport resp;
 	struct gb_spi_transfer_request *req_data;
@@ -83,9 +91,6 @@ ZTEST(greybus_spi_tests, test_transfer)
 			TRANSFER_BUF * (OP_COUNT - 1),
 		GB_SPI_TYPE_TRANSFER, false);
 
-	ret = spi_emul_register(dev, &spi_emul);
-	zassert_equal(ret, 0, "Failed to register spi device");
-
 	memset(req->payload, 0, gb_message_payload_len(req));
 
 	req_data = (struct gb_spi_transfer_request *)req->payload;
@@ -133,3 +138,39 @@ ZTEST(greybus_spi_tests, test_transfer)
 
 	gb_message_dealloc(resp.msg);
 }
+
+ZTEST(greybus_spi_tests, test_delay_does_not_block)
+{
+	struct gb_msg_with_cport resp;
+	struct gb_spi_transfer_request *req_data;
+	struct gb_message *req;
+
+	if (!IS_ENABLED(CONFIG_SPI_ASYNC)) {
+		ztest_test_skip();
+	}
+
+	req = gb_message_request_alloc(sizeof(*req_data) + sizeof(struct gb_spi_transfer),
+				       GB_SPI_TYPE_TRANSFER, false);
+	memset(req->payload, 0, gb_message_payload_len(req));
+
+	req_data = (struct gb_spi_transfer_request *)req->payload;
+	req_data->count = sys_cpu_to_le16(1);
+	req_data->transfers[0].speed_hz = 10000;
+	req_data->transfers[0].delay_usecs = sys_cpu_to_le16(20000);
+	req_data->transfers[0].xfer_flags = GB_SPI_XFER_READ;
+
+	greybus_rx_handler(1, req);
+
+	/* Let the worker start the transfer, then wait for the delay */
+	k_msleep(1);
+	greybus_rx_handler(0, gb_message_request_alloc(0, PING_TYPE, false));
+
+	resp = gb_transport_get_message();
+	zassert_equal(resp.cport, 0, "Control cport blocked by the delay");
+	gb_message_dealloc(resp.msg);
+
+	resp = gb_transport_get_message();
+	zassert_equal(resp.cport, 1, "Invalid cport");
+	zassert(gb_message_is_success(resp.msg), "Request failed");
+	gb_message_dealloc(resp.msg);
+}
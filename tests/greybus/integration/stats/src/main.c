@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus/greybus_stats.h>
+#include <greybus-utils/manifest.h>
+
+#define LOOPBACK_CPORT 1
+#define INVALID_TYPE   0x7e
+#define GB_HDR_SIZE    sizeof(struct gb_operation_msg_hdr)
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+static uint8_t request(uint8_t type)
+{
+	uint8_t result;
+	struct gb_msg_with_cport resp;
+	struct gb_message *req = gb_message_request_alloc(0, type, false);
+
+	greybus_rx_handler(LOOPBACK_CPORT, req);
+	resp = gb_transport_get_message();
+	result = resp.msg->header.result;
+	gb_message_dealloc(resp.msg);
+
+	return result;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	gb_stats_reset();
+}
+
+ZTEST_SUITE(greybus_stats_tests, NULL, NULL, before, NULL, NULL);
+
+ZTEST(greybus_stats_tests, test_cport_counters)
+{
+	struct gb_stats_cport stats;
+
+	zassert_equal(request(GB_LOOPBACK_TYPE_PING), GB_OP_SUCCESS, "Ping failed");
+	zassert_equal(request(INVALID_TYPE), GB_OP_INVALID, "Invalid request succeeded");
+
+	zassert_ok(gb_stats_cport_get(LOOPBACK_CPORT, &stats));
+	zassert_equal(stats.rx_requests, 2, "Invalid number of requests received");
+	zassert_equal(stats.rx_responses, 0, "Invalid number of responses received");
+	zassert_equal(stats.tx_requests, 0, "Invalid number of requests sent");
+	zassert_equal(stats.tx_responses, 2, "Invalid number of responses sent");
+	zassert_equal(stats.tx_results[gb_stats_result_idx(GB_OP_SUCCESS)], 1,
+		      "Invalid number of successful responses");
+	zassert_equal(stats.tx_results[gb_stats_result_idx(GB_OP_INVALID)], 1,
+		      "Invalid number of failed responses");
+	zassert_equal(stats.rx_bytes, 2 * GB_HDR_SIZE, "Invalid number of bytes received");
+	zassert_equal(stats.tx_bytes, 2 * GB_HDR_SIZE, "Invalid number of bytes sent");
+	zassert_equal(stats.queue_depth, 0, "Messages left in queue");
+	zassert_equal(stats.queue_peak, 1, "Invalid queue peak");
+
+	zassert_ok(gb_stats_cport_get(0, &stats));
+	zassert_equal(stats.rx_requests + stats.tx_responses, 0, "Traffic on control cport");
+}
+
+ZTEST(greybus_stats_tests, test_reset)
+{
+	struct gb_stats_cport stats;
+
+	zassert_equal(request(GB_LOOPBACK_TYPE_PING), GB_OP_SUCCESS, "Ping failed");
+	gb_stats_reset();
+
+	zassert_ok(gb_stats_cport_get(LOOPBACK_CPORT, &stats));
+	zassert_equal(stats.rx_requests + stats.tx_responses + stats.tx_bytes, 0,
+		      "Counters not reset");
+	zassert_equal(stats.queue_peak, 0, "Queue peak not reset");
+}
+
+ZTEST(greybus_stats_tests, test_invalid_cport)
+{
+	struct gb_stats_cport stats;
+
+	zassert_equal(gb_stats_cport_get(GREYBUS_CPORT_COUNT, &stats), -EINVAL,
+		      "Invalid cport accepted");
+}
+
+ZTEST(greybus_stats_tests, test_heap)
+{
+	struct gb_stats_heap heap;
+	struct gb_message *msg = gb_message_alloc(128, 0, 0, 0);
+
+	gb_stats_heap_get(&heap);
+	zassert_equal(heap.size, CONFIG_GREYBUS_HEAP_MEM_POOL_SIZE, "Invalid heap size");
+	zassert_true(heap.used >= 128, "Allocation not accounted");
+	zassert_true(heap.peak >= heap.used, "Peak below usage");
+	zassert_true(heap.free > 0 && heap.free <= heap.size - heap.used, "Invalid free bytes");
+	zassert_equal(heap.waits, 0, "Unexpected wait for memory");
+
+	gb_message_dealloc(msg);
+}
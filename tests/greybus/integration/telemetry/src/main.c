@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus/greybus_stats.h>
+#include <greybus-utils/manifest.h>
+
+#define LOOPBACK_CPORT 1
+#define PINGS          4
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+static struct gb_message *telemetry_request(uint8_t type, const void *payload, size_t len)
+{
+	struct gb_msg_with_cport resp;
+	struct gb_message *req = gb_message_request_alloc(len, type, false);
+
+	if (len) {
+		memcpy(req->payload, payload, len);
+	}
+	greybus_rx_handler(GREYBUS_TELEMETRY_CPORT, req);
+	resp = gb_transport_get_message();
+	zassert_equal(resp.cport, GREYBUS_TELEMETRY_CPORT, "Response on wrong cport");
+	zassert_equal(gb_message_type(resp.msg), GB_RESPONSE(type), "Invalid response type");
+
+	return resp.msg;
+}
+
+static void ping(void)
+{
+	struct gb_msg_with_cport resp;
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+
+	greybus_rx_handler(LOOPBACK_CPORT, req);
+	resp = gb_transport_get_message();
+	zassert_true(gb_message_is_success(resp.msg), "Ping failed");
+	gb_message_dealloc(resp.msg);
+}
+
+static uint32_t latency_total(const __le32 *buckets)
+{
+	size_t i;
+	uint32_t total = 0;
+
+	for (i = 0; i < GB_TELEMETRY_LATENCY_BUCKETS; i++) {
+		total += sys_le32_to_cpu(buckets[i]);
+	}
+
+	return total;
+}
+
+static void before(void *fixture)
+{
+	size_t i;
+
+	ARG_UNUSED(fixture);
+
+	gb_stats_reset();
+	for (i = 0; i < PINGS; i++) {
+		ping();
+	}
+
+	/* Let the worker record the latency of the last ping */
+	k_msleep(10);
+}
+
+ZTEST_SUITE(greybus_telemetry_tests, NULL, NULL, before, NULL, NULL);
+
+ZTEST(greybus_telemetry_tests, test_summary)
+{
+	struct gb_message *resp = telemetry_request(GB_TELEMETRY_TYPE_SUMMARY, NULL, 0);
+	const struct gb_telemetry_summary_response *summary = (const void *)resp->payload;
+
+	zassert_true(gb_message_is_success(resp), "Summary failed");
+	zassert_equal(gb_message_payload_len(resp),
+		      sizeof(*summary) + summary->pool_count * sizeof(struct gb_telemetry_pool),
+		      "Invalid response size");
+	zassert_equal(summary->version, GB_TELEMETRY_VERSION, "Invalid version");
+	zassert_equal(summary->latency_buckets, GB_TELEMETRY_LATENCY_BUCKETS,
+		      "Invalid number of buckets");
+	zassert_equal(sys_le16_to_cpu(summary->cport_count), GREYBUS_CPORT_COUNT,
+		      "Invalid number of cports");
+	zassert_equal(sys_le32_to_cpu(summary->heap_size), CONFIG_GREYBUS_HEAP_MEM_POOL_SIZE,
+		      "Invalid heap size");
+	zassert_equal(latency_total(summary->queue_latency), PINGS, "Pings not recorded");
+	zassert_equal(latency_total(summary->handler_latency), PINGS, "Pings not recorded");
+
+	gb_message_dealloc(resp);
+}
+
+ZTEST(greybus_telemetry_tests, test_cports)
+{
+	const struct gb_telemetry_cports_request req = {
+		.first = sys_cpu_to_le16(0),
+		.count = sys_cpu_to_le16(UINT16_MAX),
+	};
+	struct gb_message *resp = telemetry_request(GB_TELEMETRY_TYPE_CPORTS, &req, sizeof(req));
+	const struct gb_telemetry_cports_response *cports = (const void *)resp->payload;
+	const struct gb_telemetry_cport *loopback = &cports->cports[LOOPBACK_CPORT];
+
+	zassert_true(gb_message_is_success(resp), "Cports failed");
+	zassert_equal(sys_le16_to_cpu(cports->first), 0, "Invalid first cport");
+	zassert_equal(sys_le16_to_cpu(cports->count), GREYBUS_CPORT_COUNT,
+		      "Invalid number of cports");
+	zassert_equal(gb_message_payload_len(resp),
+		      sizeof(*cports) + GREYBUS_CPORT_COUNT * sizeof(struct gb_telemetry_cport),
+		      "Invalid response size");
+	zassert_equal(sys_le32_to_cpu(loopback->rx_requests), PINGS, "Invalid requests received");
+	zassert_equal(sys_le32_to_cpu(loopback->tx_responses), PINGS, "Invalid responses sent");
+	zassert_equal(sys_le32_to_cpu(loopback->tx_errors), 0, "Unexpected errors");
+	zassert_equal(sys_le64_to_cpu(loopback->rx_bytes),
+		      PINGS * sizeof(struct gb_operation_msg_hdr), "Invalid bytes received");
+
+	gb_message_dealloc(resp);
+}
+
+ZTEST(greybus_telemetry_tests, test_cports_invalid)
+{
+	const struct gb_telemetry_cports_request req = {
+		.first = sys_cpu_to_le16(GREYBUS_CPORT_COUNT),
+		.count = sys_cpu_to_le16(1),
+	};
+	struct gb_message *resp = telemetry_request(GB_TELEMETRY_TYPE_CPORTS, &req, sizeof(req));
+
+	zassert_equal(resp->header.result, GB_OP_INVALID, "Invalid cport accepted");
+	gb_message_dealloc(resp);
+
+	resp = telemetry_request(GB_TELEMETRY_TYPE_CPORTS, NULL, 0);
+	zassert_equal(resp->header.result, GB_OP_INVALID, "Short request accepted");
+	gb_message_dealloc(resp);
+}
+
+ZTEST(greybus_telemetry_tests, test_threads)
+{
+	size_t i;
+	bool found = false;
+	struct gb_message *resp = telemetry_request(GB_TELEMETRY_TYPE_THREADS, NULL, 0);
+	const struct gb_telemetry_threads_response *threads = (const void *)resp->payload;
+	const size_t count = sys_le16_to_cpu(threads->count);
+
+	zassert_true(gb_message_is_success(resp), "Threads failed");
+	zassert_true(count > 0, "No threads reported");
+	zassert_equal(gb_message_payload_len(resp),
+		      sizeof(*threads) + count * sizeof(struct gb_telemetry_thread),
+		      "Invalid response size");
+	zassert_true(sys_le32_to_cpu(threads->cycles_per_sec) > 0, "Invalid cycle rate");
+	zassert_true(sys_le64_to_cpu(threads->total_cycles) >=
+			     sys_le64_to_cpu(threads->busy_cycles),
+		     "Busy for longer than uptime");
+
+	for (i = 0; i < count; i++) {
+		if (!strncmp(threads->threads[i].name, "gb_dispatch",
+			     sizeof(threads->threads[i].name))) {
+			found = true;
+		}
+	}
+
+	zassert_true(found, "Dispatch worker not reported");
+	gb_message_dealloc(resp);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_trace.h"
+
+#define LOOPBACK_CPORT 1
+#define OP_ID(msg)     sys_le16_to_cpu((msg)->header.operation_id)
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+static struct gb_trace_event events[CONFIG_GREYBUS_TRACE_BUFFER_SIZE];
+
+/* Send a ping and return the number of trace events recorded for it */
+static size_t ping_traced(uint16_t *id, struct gb_trace_event *out, size_t max)
+{
+	size_t i, count, found = 0;
+	struct gb_msg_with_cport resp;
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, false);
+
+	*id = OP_ID(req);
+
+	greybus_rx_handler(LOOPBACK_CPORT, req);
+	resp = gb_transport_get_message();
+	zassert_true(gb_message_is_success(resp.msg), "Ping failed");
+	gb_message_dealloc(resp.msg);
+
+	/* Let the worker return from the handler */
+	k_msleep(10);
+
+	count = gb_trace_snapshot(events, ARRAY_SIZE(events));
+	for (i = 0; i < count && found < max; i++) {
+		if (events[i].cport == LOOPBACK_CPORT && events[i].operation_id == *id) {
+			out[found++] = events[i];
+		}
+	}
+
+	return found;
+}
+
+ZTEST_SUITE(greybus_trace_tests, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(greybus_trace_tests, test_stages)
+{
+	size_t i, count;
+	uint16_t id;
+	struct gb_trace_event traced[GB_TRACE_STAGE_COUNT * 2];
+	/* Dummy transport has no receive stage */
+	static const enum gb_trace_stage expected[] = {
+		GB_TRACE_RX_ENQUEUE,    GB_TRACE_WORKER_DEQUEUE, GB_TRACE_HANDLER_ENTRY,
+		GB_TRACE_TX_SUBMIT,     GB_TRACE_TRANSPORT_TX,   GB_TRACE_HANDLER_EXIT,
+	};
+
+	count = ping_traced(&id, traced, ARRAY_SIZE(traced));
+	zassert_equal(count, ARRAY_SIZE(expected), "Unexpected number of events");
+
+	for (i = 0; i < count; i++) {
+		zassert_equal(traced[i].stage, expected[i], "Unexpected stage %s at %zu",
+			      gb_trace_stage_name(traced[i].stage), i);
+	}
+
+	zassert_equal(traced[0].type, GB_LOOPBACK_TYPE_PING, "Invalid request type");
+	zassert_equal(traced[3].type, GB_RESPONSE(GB_LOOPBACK_TYPE_PING), "Invalid response type");
+
+	for (i = 1; i < count; i++) {
+		zassert_true((int32_t)(traced[i].cycles - traced[i - 1].cycles) >= 0,
+			     "Timestamps out of order");
+	}
+}
+
+ZTEST(greybus_trace_tests, test_overwrite)
+{
+	size_t i, count;
+	uint16_t id;
+	struct gb_trace_event traced[GB_TRACE_STAGE_COUNT * 2];
+
+	/* Older pings are overwritten, while the latest one is complete */
+	for (i = 0; i < CONFIG_GREYBUS_TRACE_BUFFER_SIZE / 4; i++) {
+		count = ping_traced(&id, traced, ARRAY_SIZE(traced));
+		zassert_equal(count, GB_TRACE_STAGE_COUNT - 1, "Unexpected number of events");
+	}
+
+	count = gb_trace_snapshot(events, ARRAY_SIZE(events));
+	zassert_equal(count, CONFIG_GREYBUS_TRACE_BUFFER_SIZE, "Buffer not full");
+
+	count = gb_trace_snapshot(events, 3);
+	zassert_equal(count, 3, "Unexpected number of events");
+	zassert_equal(events[2].operation_id, id, "Not the most recent events");
+	zassert_equal(events[2].stage, GB_TRACE_HANDLER_EXIT, "Not the most recent events");
+}
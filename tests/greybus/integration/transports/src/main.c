@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "greybus/greybus_messages.h"
+#include "greybus/greybus_protocols.h"
+#include <zephyr/ztest.h>
+#include <greybus/greybus.h>
+#include <greybus-utils/manifest.h>
+#include "greybus_cport.h"
+#include "greybus_transport.h"
+
+#define CONTROL_CPORT 0
+#define GPIO_CPORT    1
+
+struct gb_msg_with_cport gb_transport_get_message(void);
+
+static void cport_connected(uint16_t cport)
+{
+	struct gb_msg_with_cport resp;
+	struct gb_control_connected_request *req_data;
+	struct gb_message *msg =
+		gb_message_request_alloc(sizeof(*req_data), GB_CONTROL_TYPE_CONNECTED, false);
+
+	req_data = (struct gb_control_connected_request *)msg->payload;
+	req_data->cport_id = sys_cpu_to_le16(cport);
+
+	greybus_rx_handler(CONTROL_CPORT, msg);
+
+	/* Control responses stay on the default transport */
+	resp = gb_transport_get_message();
+	zassert_equal(resp.cport, CONTROL_CPORT, "Invalid Cport");
+	zassert(gb_message_is_success(resp.msg), "Connected request failed");
+
+	gb_message_dealloc(resp.msg);
+}
+
+ZTEST_SUITE(greybus_transports_tests, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(greybus_transports_tests, test_registry)
+{
+	zassert_equal(gb_transport_backends[GB_TRANSPORT_DUMMY], &gb_trans_backend_dummy,
+		      "Dummy transport not registered");
+	zassert_equal(gb_transport_backends[GB_TRANSPORT_UDP], &gb_trans_backend_udp,
+		      "UDP transport not registered");
+	zassert_is_null(gb_transport_backends[GB_TRANSPORT_TCPIP], "TCP/IP transport registered");
+	zassert_equal(gb_transport_get_default_backend(), &gb_trans_backend_dummy,
+		      "Invalid default transport");
+	zassert_equal(gb_cport_get(GPIO_CPORT)->transport, GB_TRANSPORT_UDP,
+		      "Devicetree transport not applied");
+}
+
+ZTEST(greybus_transports_tests, test_bind_on_connected)
+{
+	zassert_equal(gb_transport_get_backend(CONTROL_CPORT), &gb_trans_backend_dummy,
+		      "Control cport not on default transport");
+
+	cport_connected(GPIO_CPORT);
+
+	zassert_equal(gb_transport_get_backend(GPIO_CPORT), &gb_trans_backend_udp,
+		      "Cport not bound to its transport");
+	zassert_equal(gb_transport_get_backend(CONTROL_CPORT), &gb_trans_backend_dummy,
+		      "Control cport moved");
+}
+
+ZTEST(greybus_transports_tests, test_bind_disabled)
+{
+	zassert_equal(gb_transport_bind(GPIO_CPORT, GB_TRANSPORT_SERIAL), -ENOTSUP,
+		      "Bound to disabled transport");
+	zassert_equal(gb_transport_bind(GREYBUS_CPORT_COUNT, GB_TRANSPORT_DUMMY), -ENOTSUP,
+		      "Bound invalid cport");
+}
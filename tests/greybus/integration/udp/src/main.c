@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2026 Ayush Singh, BeagleBoard.org
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
+#include <greybus/greybus.h>
+#include <greybus/greybus_messages.h>
+#include <greybus-utils/manifest.h>
+#include "transport/udp.h"
+
+#define UDP_PORT       4242
+#define LOOPBACK_CPORT 1
+#define DGRAM_MAX      256
+/* Longer than the retransmission timeout */
+#define WAIT_MS        (CONFIG_GREYBUS_UDP_RETRANSMIT_TIMEOUT_MS * 3)
+
+static int sock = -1;
+static uint16_t seq;
+static uint8_t session;
+
+/* Send a message the way the AP would. @return sequence number of the datagram */
+static uint16_t send_msg(uint16_t cport, const struct gb_message *msg, uint8_t flags)
+{
+	uint8_t dgram[DGRAM_MAX];
+	const size_t len = sys_le16_to_cpu(msg->header.size);
+	const struct gb_udp_hdr hdr = {
+		.seq = sys_cpu_to_le16(seq),
+		.flags = flags,
+		.session = session,
+		.cport = sys_cpu_to_le16(cport),
+	};
+
+	memcpy(dgram, &hdr, sizeof(hdr));
+	memcpy(dgram + sizeof(hdr), msg, len);
+	zassert_equal(zsock_send(sock, dgram, sizeof(hdr) + len, 0), sizeof(hdr) + len,
+		      "Failed to send datagram");
+
+	return seq++;
+}
+
+static uint16_t send_ping(uint8_t flags, bool oneshot)
+{
+	uint16_t ret;
+	struct gb_message *req = gb_message_request_alloc(0, GB_LOOPBACK_TYPE_PING, oneshot);
+
+	ret = send_msg(LOOPBACK_CPORT, req, flags);
+	gb_message_dealloc(req);
+
+	return ret;
+}
+
+static void send_ack_from(int from, uint16_t ack_seq)
+{
+	const struct gb_udp_hdr hdr = {
+		.seq = sys_cpu_to_le16(ack_seq),
+		.flags = GB_UDP_FLAG_ACK,
+		.session = session,
+	};
+
+	zassert_equal(zsock_send(from, &hdr, sizeof(hdr), 0), sizeof(hdr), "Failed to send ack");
+}
+
+static void send_ack(uint16_t ack_seq)
+{
+	send_ack_from(sock, ack_seq);
+}
+
+/* @return length of the datagram. 0 if none arrived in time. */
+static size_t recv_dgram(uint8_t *buf, int timeout_ms)
+{
+	int ret;
+	struct zsock_pollfd fd = {
+		.fd = sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	ret = zsock_poll(&fd, 1, timeout_ms);
+	zassert_true(ret >= 0, "Poll failed");
+	if (ret == 0) {
+		return 0;
+	}
+
+	ret = zsock_recv(sock, buf, DGRAM_MAX, 0);
+	zassert_true(ret >= (int)sizeof(struct gb_udp_hdr), "Invalid datagram");
+
+	return ret;
+}
+
+static void expect_ack(uint16_t ack_seq)
+{
+	uint8_t buf[DGRAM_MAX];
+	const struct gb_udp_hdr *hdr = (const void *)buf;
+
+	zassert_true(recv_dgram(buf, WAIT_MS) > 0, "No ack");
+	zassert_true(hdr->flags & GB_UDP_FLAG_ACK, "Not an ack");
+	zassert_equal(sys_le16_to_cpu(hdr->seq), ack_seq, "Ack of wrong datagram");
+}
+
+/* @return sequence number of the response */
+static uint16_t expect_pong(void)
+{
+	uint8_t buf[DGRAM_MAX];
+	const struct gb_udp_hdr *hdr = (const void *)buf;
+	const struct gb_operation_msg_hdr *msg = (const void *)(buf + sizeof(*hdr));
+	const size_t len = recv_dgram(buf, WAIT_MS);
+
+	zassert_equal(len, sizeof(*hdr) + sizeof(*msg), "Invalid response size");
+	zassert_equal(hdr->flags, GB_UDP_FLAG_RELIABLE, "Response is not reliable");
+	zassert_equal(sys_le16_to_cpu(hdr->cport), LOOPBACK_CPORT, "Response on wrong cport");
+	zassert_equal(msg->type, GB_RESPONSE(GB_LOOPBACK_TYPE_PING), "Invalid response type");
+	zassert_equal(msg->result, GB_OP_SUCCESS, "Ping failed");
+
+	return sys_le16_to_cpu(hdr->seq);
+}
+
+static void expect_nothing(void)
+{
+	uint8_t buf[DGRAM_MAX];
+
+	zassert_equal(recv_dgram(buf, WAIT_MS), 0, "Unexpected datagram");
+}
+
+static struct gb_udp_stats stats(void)
+{
+	struct gb_udp_stats s;
+
+	gb_udp_stats_get(&s);
+	return s;
+}
+
+/* @return socket connected to the node */
+static int node_socket(void)
+{
+	int ret;
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_addr = IN6ADDR_LOOPBACK_INIT,
+		.sin6_port = htons(UDP_PORT),
+	};
+
+	ret = zsock_socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(ret >= 0, "Failed to create socket");
+	zassert_ok(zsock_connect(ret, (struct sockaddr *)&addr, sizeof(addr)),
+		   "Failed to connect socket");
+
+	return ret;
+}
+
+static void *setup(void)
+{
+	sock = node_socket();
+
+	return NULL;
+}
+
+ZTEST_SUITE(greybus_udp_tests, NULL, setup, NULL, NULL, NULL);
+
+ZTEST(greybus_udp_tests, test_ping)
+{
+	const uint16_t req_seq = send_ping(GB_UDP_FLAG_RELIABLE, false);
+
+	expect_ack(req_seq);
+	send_ack(expect_pong());
+	expect_nothing();
+}
+
+ZTEST(greybus_udp_tests, test_duplicate_request)
+{
+	const uint32_t duplicates = stats().rx_duplicates;
+	const uint16_t req_seq = send_ping(GB_UDP_FLAG_RELIABLE, false);
+
+	expect_ack(req_seq);
+	send_ack(expect_pong());
+
+	/* A retransmission after a lost ack is acknowledged again, but not handled again */
+	seq = req_seq;
+	send_ping(GB_UDP_FLAG_RELIABLE, false);
+	expect_ack(req_seq);
+	expect_nothing();
+	zassert_equal(stats().rx_duplicates, duplicates + 1, "Duplicate not counted");
+}
+
+ZTEST(greybus_udp_tests, test_retransmit)
+{
+	uint16_t resp_seq;
+	const uint32_t retransmits = stats().tx_retransmits;
+	const uint16_t req_seq = send_ping(GB_UDP_FLAG_RELIABLE, false);
+
+	expect_ack(req_seq);
+	resp_seq = expect_pong();
+
+	/* Without an ack, the same response is sent again */
+	zassert_equal(expect_pong(), resp_seq, "Retransmission has a new sequence number");
+	send_ack(resp_seq);
+	expect_nothing();
+	zassert_true(stats().tx_retransmits > retransmits, "Retransmission not counted");
+}
+
+ZTEST(greybus_udp_tests, test_unidirectional_not_acked)
+{
+	/* Unidirectional requests are best effort, and get neither an ack nor a response */
+	send_ping(0, true);
+	expect_nothing();
+}
+
+ZTEST(greybus_udp_tests, test_malformed)
+{
+	const uint32_t errors = stats().rx_errors;
+	const uint8_t garbage[] = {0x01, 0x00, GB_UDP_FLAG_RELIABLE, 0x00, 0x01, 0x00, 0xff};
+
+	zassert_equal(zsock_send(sock, garbage, sizeof(garbage), 0), sizeof(garbage),
+		      "Failed to send datagram");
+	expect_nothing();
+	zassert_equal(stats().rx_errors, errors + 1, "Malformed datagram not counted");
+}
+
+ZTEST(greybus_udp_tests, test_peer_restart)
+{
+	uint16_t req_seq = send_ping(GB_UDP_FLAG_RELIABLE, false);
+
+	expect_ack(req_seq);
+	send_ack(expect_pong());
+
+	/* A restarted AP reuses sequence numbers with a new session, and is not a duplicate */
+	session++;
+	seq = req_seq;
+	req_seq = send_ping(GB_UDP_FLAG_RELIABLE, false);
+	expect_ack(req_seq);
+	send_ack(expect_pong());
+	expect_nothing();
+}
+
+ZTEST(greybus_udp_tests, test_ack_from_other_host)
+{
+	uint16_t resp_seq;
+	const int other = node_socket();
+	const uint16_t req_seq = send_ping(GB_UDP_FLAG_RELIABLE, false);
+
+	expect_ack(req_seq);
+	resp_seq = expect_pong();
+
+	/* Only the peer can acknowledge, so the response is still retransmitted */
+	send_ack_from(other, resp_seq);
+	zassert_equal(expect_pong(), resp_seq, "Acknowledged by another host");
+	send_ack(resp_seq);
+	expect_nothing();
+
+	zsock_close(other);
+}